@@ -0,0 +1,71 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+namespace Hatchit {
+
+    namespace Bench {
+
+        inline uint64_t NowNanoseconds()
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        /*
+        * Runs fn `repeats` times and returns the fastest run in nanoseconds.
+        * The fastest run is the one least disturbed by the OS, which makes
+        * it the most stable number to compare between builds.
+        */
+        template <typename Function>
+        uint64_t BestOf(uint32_t repeats, Function fn)
+        {
+            uint64_t best = UINT64_MAX;
+            for (uint32_t i = 0; i < repeats; i++)
+            {
+                uint64_t start = NowNanoseconds();
+                fn();
+                best = std::min(best, NowNanoseconds() - start);
+            }
+            return best;
+        }
+
+        inline double Milliseconds(uint64_t nanoseconds)
+        {
+            return static_cast<double>(nanoseconds) / 1000000.0;
+        }
+
+        /*Keeps the optimizer from discarding a result nobody reads*/
+        template <typename T>
+        inline void DoNotOptimize(const T& value)
+        {
+            static volatile T sink;
+            sink = value;
+            (void)sink;
+        }
+
+        void JobSystemScaling();
+        void TripleBufferThroughput();
+        void BackendDispatch();
+        void EcsScaling();
+        void BroadphaseScaling();
+    }
+
+}
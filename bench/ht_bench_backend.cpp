@@ -0,0 +1,153 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include "ht_bench.h"
+
+#include <ht_static_backend.h>
+#include <ht_nullwindow.h>
+#include <ht_nullrenderer.h>
+
+namespace Hatchit {
+
+    namespace Bench {
+
+        using namespace Game;
+
+        namespace
+        {
+            typedef StaticBackend<NullWindow, NullRenderer> DirectBackend;
+
+            /*
+            * The DynamicBackend calls minus the singleton lookup. The pointers
+            * go through volatile so the compiler cannot see the final types
+            * and devirtualize, which the engine's runtime selection rules out.
+            */
+            struct VirtualBackend
+            {
+                static IWindow*               s_window;
+                static Graphics::IRenderer*   s_renderer;
+
+                static bool IsRunning() { return s_window->VIsRunning(); }
+
+                static void PollEvents() { s_window->VPollEvents(); }
+
+                static void SwapBuffers() { s_window->VSwapBuffers(); }
+
+                static bool IsVisible() { return s_window->VIsVisible(); }
+
+                static bool HasFocus() { return s_window->VHasFocus(); }
+
+                static void Execute(const RenderCommand& command)
+                {
+                    switch (command.type)
+                    {
+                    case RenderCommandType::SET_CLEAR_COLOR:
+                        s_renderer->VSetClearColor(Graphics::Color(command.color.r, command.color.g, command.color.b, command.color.a));
+                        break;
+
+                    case RenderCommandType::CLEAR:
+                        s_renderer->VClearBuffer(command.clear);
+                        break;
+
+                    case RenderCommandType::RESIZE:
+                        s_renderer->VResizeBuffers(command.resize.width, command.resize.height);
+                        break;
+
+                    case RenderCommandType::PRESENT:
+                        s_renderer->VPresent();
+                        break;
+                    }
+                }
+            };
+
+            IWindow*             VirtualBackend::s_window = nullptr;
+            Graphics::IRenderer* VirtualBackend::s_renderer = nullptr;
+
+            /*The per-frame backend calls Application::Run makes for a clear and present*/
+            template <typename TBackend>
+            uint32_t RunFrames(uint32_t frames, const RenderCommandBuffer& commands)
+            {
+                uint32_t drawn = 0;
+                for (uint32_t i = 0; i < frames && TBackend::IsRunning(); i++)
+                {
+                    TBackend::PollEvents();
+                    if (!TBackend::IsVisible() || !TBackend::HasFocus())
+                        continue;
+
+                    for (uint32_t c = 0; c < commands.Count(); c++)
+                        TBackend::Execute(commands.Commands()[c]);
+
+                    TBackend::SwapBuffers();
+                    drawn++;
+                }
+                return drawn;
+            }
+        }
+
+        /*
+        * Per-frame cost of StaticBackend against calls through the IWindow
+        * and IRenderer interfaces, with the null backends so only dispatch
+        * is measured. The backends live in their own translation units, so
+        * without LTO this compares direct calls to indirect calls; with LTO
+        * the static path can also inline.
+        */
+        void BackendDispatch()
+        {
+            static const uint32_t FRAMES = 1000000;
+            static const uint32_t REPEATS = 10;
+
+            WindowParams params = WindowParams();
+            params.backend = WindowBackend::HEADLESS;
+            params.frameCount = 0;
+
+            NullWindow window(params);
+            NullRenderer renderer;
+            window.VInitialize();
+
+            RenderCommandBuffer commands;
+            commands.SetClearColor(Graphics::Color(0.0f, 0.0f, 0.0f, 1.0f));
+            commands.Clear(Graphics::ClearArgs::ColorDepthStencil);
+            commands.Present();
+
+            DirectBackend::BindWindow(&window);
+            DirectBackend::BindRenderer(&renderer);
+
+            IWindow* volatile opaqueWindow = &window;
+            Graphics::IRenderer* volatile opaqueRenderer = &renderer;
+            VirtualBackend::s_window = opaqueWindow;
+            VirtualBackend::s_renderer = opaqueRenderer;
+
+            /*Alternate the two so drift in clock speed or load hits both alike*/
+            uint32_t drawn = 0;
+            uint64_t direct = UINT64_MAX;
+            uint64_t indirect = UINT64_MAX;
+            for (uint32_t i = 0; i < REPEATS; i++)
+            {
+                direct = std::min(direct, BestOf(1, [&]() { drawn += RunFrames<DirectBackend>(FRAMES, commands); }));
+                indirect = std::min(indirect, BestOf(1, [&]() { drawn += RunFrames<VirtualBackend>(FRAMES, commands); }));
+            }
+            DoNotOptimize(drawn);
+
+            DirectBackend::BindWindow(nullptr);
+            DirectBackend::BindRenderer(nullptr);
+
+            double directNs = static_cast<double>(direct) / FRAMES;
+            double indirectNs = static_cast<double>(indirect) / FRAMES;
+            std::printf("%u frames of %u commands, best of %u\n", FRAMES, commands.Count(), REPEATS);
+            std::printf("static:  %.2f ns/frame\n", directNs);
+            std::printf("virtual: %.2f ns/frame (%+.1f%%)\n", indirectNs, 100.0 * (indirectNs - directNs) / directNs);
+        }
+    }
+
+}
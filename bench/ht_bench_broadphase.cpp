@@ -0,0 +1,158 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include "ht_bench.h"
+
+#include <ht_broadphase.h>
+#include <ht_jobsystem.h>
+
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace Hatchit {
+
+    namespace Bench {
+
+        using namespace Game;
+
+        namespace
+        {
+            static const float CELL_SIZE = 4.0f;
+            static const float SPACING = 4.0f;
+
+            /*Deterministic so runs and builds see the same scene*/
+            struct Random
+            {
+                uint32_t state;
+
+                float Next(float lo, float hi)
+                {
+                    state ^= state << 13;
+                    state ^= state >> 17;
+                    state ^= state << 5;
+                    return lo + (hi - lo) * static_cast<float>(state >> 8) / 16777216.0f;
+                }
+            };
+
+            Bounds Box(const float center[3], float halfExtent)
+            {
+                Bounds bounds;
+                for (int a = 0; a < 3; a++)
+                {
+                    bounds.min[a] = center[a] - halfExtent;
+                    bounds.max[a] = center[a] + halfExtent;
+                }
+                return bounds;
+            }
+        }
+
+        /*
+        * Broadphase cost as the object count grows at constant density (one
+        * object per SPACING^3), so a working grid keeps per-query cost flat.
+        * Reports insert and Update cost, then ns per AABB, radius and ray
+        * query with the average number of hits.
+        */
+        void BroadphaseScaling()
+        {
+            static const uint32_t COUNTS[] = { 1000, 10000, 100000, 1000000 };
+            static const uint32_t QUERIES = 10000;
+            static const uint32_t CAPACITY = 4096;
+            static const uint32_t REPEATS = 5;
+
+            uint32_t workers = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+            if (!JobSystem::Initialize(static_cast<int>(workers)))
+            {
+                std::printf("job system failed to start\n");
+                return;
+            }
+
+            std::printf("%u queries per kind, %u workers, best of %u\n", QUERIES, workers, REPEATS);
+            std::printf("%8s %10s %10s %9s %14s %14s %14s\n",
+                "objects", "insert ns", "update ms", "pairs", "aabb ns (hits)", "radius", "ray");
+
+            std::vector<ProxyId> hits(CAPACITY);
+            std::vector<RayHit> rayHits(CAPACITY);
+
+            for (uint32_t count : COUNTS)
+            {
+                float side = std::ceil(std::cbrt(static_cast<float>(count))) * SPACING;
+                uint32_t cells = static_cast<uint32_t>(std::ceil(side / CELL_SIZE));
+
+                BroadphaseParams params;
+                params.origin[0] = params.origin[1] = params.origin[2] = 0.0f;
+                params.cellSize = CELL_SIZE;
+                params.cells[0] = params.cells[1] = params.cells[2] = cells;
+
+                Random random = { 0x12345678u };
+                std::vector<Bounds> bounds(count);
+                for (uint32_t i = 0; i < count; i++)
+                {
+                    float center[3] = { random.Next(0.0f, side), random.Next(0.0f, side), random.Next(0.0f, side) };
+                    bounds[i] = Box(center, random.Next(0.25f, 1.5f));
+                }
+
+                Broadphase broadphase;
+                broadphase.Configure(params);
+                broadphase.Reserve(count);
+
+                std::vector<ProxyId> ids(count);
+                uint64_t insert = BestOf(1, [&]() { broadphase.Insert(bounds.data(), count, ids.data()); });
+                uint64_t update = BestOf(REPEATS, [&]()
+                {
+                    broadphase.Move(ids.data(), bounds.data(), count);
+                    broadphase.Update();
+                });
+
+                std::vector<float> centers(QUERIES * 3);
+                for (float& c : centers)
+                    c = random.Next(0.0f, side);
+
+                uint64_t aabbHits = 0;
+                uint64_t aabb = BestOf(REPEATS, [&]()
+                {
+                    aabbHits = 0;
+                    for (uint32_t q = 0; q < QUERIES; q++)
+                        aabbHits += broadphase.QueryAABB(Box(&centers[q * 3], 4.0f), hits.data(), CAPACITY);
+                });
+
+                uint64_t radiusHits = 0;
+                uint64_t radius = BestOf(REPEATS, [&]()
+                {
+                    radiusHits = 0;
+                    for (uint32_t q = 0; q < QUERIES; q++)
+                        radiusHits += broadphase.QueryRadius(&centers[q * 3], 4.0f, hits.data(), CAPACITY);
+                });
+
+                static const float DIRECTION[3] = { 0.57735f, 0.57735f, 0.57735f };
+                uint64_t rayCount = 0;
+                uint64_t ray = BestOf(REPEATS, [&]()
+                {
+                    rayCount = 0;
+                    for (uint32_t q = 0; q < QUERIES; q++)
+                        rayCount += broadphase.QueryRay(&centers[q * 3], DIRECTION, 32.0f, rayHits.data(), CAPACITY);
+                });
+
+                std::printf("%8u %10.1f %10.3f %9u %7.0f (%4.1f) %7.0f (%4.1f) %7.0f (%4.1f)\n", count,
+                    static_cast<double>(insert) / count, Milliseconds(update), broadphase.PairCount(),
+                    static_cast<double>(aabb) / QUERIES, static_cast<double>(aabbHits) / QUERIES,
+                    static_cast<double>(radius) / QUERIES, static_cast<double>(radiusHits) / QUERIES,
+                    static_cast<double>(ray) / QUERIES, static_cast<double>(rayCount) / QUERIES);
+            }
+
+            JobSystem::DeInitialize();
+        }
+    }
+
+}
@@ -0,0 +1,157 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include "ht_bench.h"
+
+#include <ht_world.h>
+#include <ht_jobsystem.h>
+
+#include <thread>
+#include <vector>
+
+namespace Hatchit {
+
+    namespace Bench {
+
+        using namespace Game;
+
+        namespace
+        {
+            struct Position
+            {
+                float x, y, z;
+            };
+
+            struct Velocity
+            {
+                float x, y, z;
+            };
+
+            struct Tag
+            {
+                uint32_t value;
+            };
+
+            double PerEntity(uint64_t nanoseconds, uint32_t count)
+            {
+                return static_cast<double>(nanoseconds) / count;
+            }
+        }
+
+        /*
+        * World costs at 10k, 100k and 1M entities: creation, Each, EachChunk
+        * and ParallelEach over Position+Velocity, adding then removing a
+        * component on every entity (two archetype moves), and destruction.
+        * Every figure is nanoseconds per entity.
+        */
+        void EcsScaling()
+        {
+            static const uint32_t COUNTS[] = { 10000, 100000, 1000000 };
+            static const uint32_t REPEATS = 5;
+
+            uint32_t workers = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+            if (!JobSystem::Initialize(static_cast<int>(workers)))
+            {
+                std::printf("job system failed to start\n");
+                return;
+            }
+
+            std::printf("ns/entity, %u workers, best of %u\n", workers, REPEATS);
+            std::printf("%9s %9s %9s %10s %9s %9s %9s %9s\n",
+                "entities", "create", "each", "eachchunk", "parallel", "add", "remove", "destroy");
+
+            for (uint32_t count : COUNTS)
+            {
+                World* world = new World();
+                world->Initialize(JobSystem::ThreadCount());
+
+                std::vector<Entity> entities(count);
+                uint64_t create = BestOf(1, [&]()
+                {
+                    for (uint32_t i = 0; i < count; i++)
+                        entities[i] = world->Create(Position{ float(i), 0.0f, 0.0f }, Velocity{ 1.0f, 2.0f, 3.0f });
+                });
+
+                uint64_t each = BestOf(REPEATS, [&]()
+                {
+                    world->Each<Position, Velocity>([](Entity, Position& p, Velocity& v)
+                    {
+                        p.x += v.x;
+                        p.y += v.y;
+                        p.z += v.z;
+                    });
+                });
+
+                uint64_t eachChunk = BestOf(REPEATS, [&]()
+                {
+                    world->EachChunk<Position, Velocity>([](uint32_t rows, const Entity*, Position* p, Velocity* v)
+                    {
+                        for (uint32_t i = 0; i < rows; i++)
+                        {
+                            p[i].x += v[i].x;
+                            p[i].y += v[i].y;
+                            p[i].z += v[i].z;
+                        }
+                    });
+                });
+
+                uint64_t parallel = BestOf(REPEATS, [&]()
+                {
+                    world->ParallelEach<Position, Velocity>([](Entity, Position& p, Velocity& v)
+                    {
+                        p.x += v.x;
+                        p.y += v.y;
+                        p.z += v.z;
+                    });
+                });
+
+                uint64_t add = UINT64_MAX;
+                uint64_t remove = UINT64_MAX;
+                for (uint32_t r = 0; r < REPEATS; r++)
+                {
+                    add = std::min(add, BestOf(1, [&]()
+                    {
+                        for (uint32_t i = 0; i < count; i++)
+                            world->Add(entities[i], Tag{ i });
+                    }));
+
+                    remove = std::min(remove, BestOf(1, [&]()
+                    {
+                        for (uint32_t i = 0; i < count; i++)
+                            world->Remove<Tag>(entities[i]);
+                    }));
+                }
+
+                DoNotOptimize(world->Get<Position>(entities[count / 2])->x);
+
+                uint64_t destroy = BestOf(1, [&]()
+                {
+                    for (uint32_t i = 0; i < count; i++)
+                        world->Destroy(entities[i]);
+                });
+
+                std::printf("%9u %9.1f %9.2f %10.2f %9.2f %9.1f %9.1f %9.1f\n", count,
+                    PerEntity(create, count), PerEntity(each, count), PerEntity(eachChunk, count),
+                    PerEntity(parallel, count), PerEntity(add, count), PerEntity(remove, count),
+                    PerEntity(destroy, count));
+
+                world->DeInitialize();
+                delete world;
+            }
+
+            JobSystem::DeInitialize();
+        }
+    }
+
+}
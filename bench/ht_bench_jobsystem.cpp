@@ -0,0 +1,107 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include "ht_bench.h"
+
+#include <ht_jobsystem.h>
+
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace Hatchit {
+
+    namespace Bench {
+
+        using namespace Game;
+
+        /*A few dependent square roots per element: enough work to outweigh scheduling*/
+        static void WorkloadBatch(uint32_t begin, uint32_t end, void* data)
+        {
+            float* values = static_cast<float*>(data);
+            for (uint32_t i = begin; i < end; i++)
+            {
+                float x = values[i];
+                for (int k = 0; k < 16; k++)
+                    x = std::sqrt(x * x + 1.0f) * 0.5f;
+                values[i] = x;
+            }
+        }
+
+        static void EmptyJob(void*)
+        {
+        }
+
+        /*
+        * Runs the same ParallelFor workload with 0..N workers and reports
+        * time per pass and the speedup over the main thread alone, plus the
+        * per-job overhead of Run/Wait on empty jobs.
+        */
+        void JobSystemScaling()
+        {
+            static const uint32_t ITEMS = 1u << 20;
+            static const uint32_t BATCH = 1024;
+            static const uint32_t REPEATS = 20;
+            static const uint32_t EMPTY_JOBS = 256;
+
+            uint32_t hardware = std::max(std::thread::hardware_concurrency(), 1u);
+            std::vector<uint32_t> workerCounts;
+            for (uint32_t workers = 0; workers < hardware; workers = workers ? workers * 2 : 1)
+                workerCounts.push_back(workers);
+            if (workerCounts.back() != hardware - 1)
+                workerCounts.push_back(hardware - 1);
+
+            std::vector<float> values(ITEMS, 1.0f);
+            std::vector<Job> jobs(EMPTY_JOBS, Job{ &EmptyJob, nullptr, nullptr });
+
+            std::printf("%u items, batch %u, best of %u\n", ITEMS, BATCH, REPEATS);
+            std::printf("%8s %12s %10s %14s\n", "workers", "ms/pass", "speedup", "ns/empty job");
+
+            double baseline = 0.0;
+            for (uint32_t workers : workerCounts)
+            {
+                if (!JobSystem::Initialize(static_cast<int>(workers)))
+                {
+                    std::printf("%8u failed to start\n", workers);
+                    continue;
+                }
+
+                uint64_t pass = BestOf(REPEATS, [&]()
+                {
+                    JobSystem::ParallelFor(ITEMS, BATCH, &WorkloadBatch, values.data());
+                });
+
+                uint64_t empty = BestOf(REPEATS, [&]()
+                {
+                    JobCounter counter;
+                    JobSystem::Run(jobs.data(), EMPTY_JOBS, &counter);
+                    JobSystem::Wait(&counter);
+                });
+
+                JobSystem::DeInitialize();
+
+                double ms = Milliseconds(pass);
+                if (workers == 0)
+                    baseline = ms;
+
+                std::printf("%8u %12.3f %9.2fx %14.1f\n", workers, ms,
+                    baseline > 0.0 ? baseline / ms : 0.0,
+                    static_cast<double>(empty) / EMPTY_JOBS);
+            }
+
+            DoNotOptimize(values[ITEMS / 2]);
+        }
+    }
+
+}
@@ -0,0 +1,71 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include "ht_bench.h"
+
+#include <cstring>
+
+using namespace Hatchit;
+
+namespace
+{
+    struct Benchmark
+    {
+        const char* name;
+        void (*run)();
+    };
+
+    const Benchmark BENCHMARKS[] =
+    {
+        { "jobsystem",     &Bench::JobSystemScaling },
+        { "triplebuffer",  &Bench::TripleBufferThroughput },
+        { "backend",       &Bench::BackendDispatch },
+        { "ecs",           &Bench::EcsScaling },
+        { "broadphase",    &Bench::BroadphaseScaling },
+    };
+}
+
+/*
+* Usage: ht_bench [name...]
+* Runs every benchmark, or only the ones named on the command line.
+*/
+int main(int argc, char* argv[])
+{
+    int ran = 0;
+    for (const Benchmark& bench : BENCHMARKS)
+    {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc && !selected; i++)
+            selected = std::strcmp(argv[i], bench.name) == 0;
+
+        if (!selected)
+            continue;
+
+        std::printf("== %s ==\n", bench.name);
+        bench.run();
+        std::printf("\n");
+        ran++;
+    }
+
+    if (ran == 0)
+    {
+        std::printf("No benchmark matched. Available:");
+        for (const Benchmark& bench : BENCHMARKS)
+            std::printf(" %s", bench.name);
+        std::printf("\n");
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,123 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include "ht_bench.h"
+
+#include <ht_triple_buffer.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace Hatchit {
+
+    namespace Bench {
+
+        using namespace Game;
+
+        namespace
+        {
+            /*Roughly the size of a RenderView: a few cache lines per publish*/
+            struct Stamped
+            {
+                uint64_t publishedAt;
+                uint64_t sequence;
+                float    payload[62];
+            };
+        }
+
+        /*
+        * Uncontended Publish/Acquire cost, then a writer racing a spinning
+        * reader for a fixed time: publish and acquire rates, and the
+        * publish-to-acquire latency the reader observed.
+        */
+        void TripleBufferThroughput()
+        {
+            static const uint32_t OPS = 1000000;
+            static const uint64_t RACE_NS = 500000000;
+
+            TripleBuffer<Stamped> buffer;
+
+            uint64_t publish = BestOf(5, [&]()
+            {
+                for (uint32_t i = 0; i < OPS; i++)
+                {
+                    buffer.WriteBuffer().sequence = i;
+                    buffer.Publish();
+                }
+            });
+
+            uint64_t acquire = BestOf(5, [&]()
+            {
+                uint32_t fresh = 0;
+                for (uint32_t i = 0; i < OPS; i++)
+                {
+                    buffer.Publish();
+                    fresh += buffer.Acquire() ? 1 : 0;
+                }
+                DoNotOptimize(fresh);
+            });
+
+            std::printf("uncontended: %.1f ns/publish, %.1f ns/publish+acquire\n",
+                static_cast<double>(publish) / OPS, static_cast<double>(acquire) / OPS);
+
+            std::atomic<bool> done(false);
+            std::vector<uint64_t> latencies;
+            latencies.reserve(1u << 20);
+            uint64_t acquired = 0;
+
+            std::thread reader([&]()
+            {
+                while (!done.load(std::memory_order_relaxed))
+                {
+                    if (!buffer.Acquire())
+                        continue;
+
+                    uint64_t now = NowNanoseconds();
+                    acquired++;
+                    if (latencies.size() < latencies.capacity())
+                        latencies.push_back(now - buffer.ReadBuffer().publishedAt);
+                }
+            });
+
+            uint64_t published = 0;
+            uint64_t start = NowNanoseconds();
+            uint64_t now = start;
+            while (now - start < RACE_NS)
+            {
+                Stamped& value = buffer.WriteBuffer();
+                value.sequence = published++;
+                value.publishedAt = now = NowNanoseconds();
+                buffer.Publish();
+            }
+            done.store(true);
+            reader.join();
+
+            double seconds = static_cast<double>(now - start) / 1e9;
+            std::printf("contended:   %.2f M publish/s, %.2f M acquire/s (%.1f%% of publishes seen)\n",
+                published / seconds / 1e6, acquired / seconds / 1e6,
+                published ? 100.0 * acquired / published : 0.0);
+
+            if (latencies.empty())
+                return;
+
+            std::sort(latencies.begin(), latencies.end());
+            std::printf("latency:     p50 %llu ns, p99 %llu ns, max %llu ns\n",
+                (unsigned long long)latencies[latencies.size() / 2],
+                (unsigned long long)latencies[latencies.size() * 99 / 100],
+                (unsigned long long)latencies.back());
+        }
+    }
+
+}
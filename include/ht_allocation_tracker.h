@@ -0,0 +1,71 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#pragma once
+
+#include <ht_platform.h>
+
+/*
+* Debug builds replace the global operator new so the main loop can check
+* that a steady-state frame makes no heap allocations. Define
+* HT_NO_ALLOCATION_TRACKING to opt out, e.g. when using a custom allocator.
+*/
+#if defined(_DEBUG) && !defined(HT_NO_ALLOCATION_TRACKING)
+#define HT_TRACK_ALLOCATIONS
+#endif
+
+namespace Hatchit {
+
+    namespace Game {
+
+        class HT_API AllocationTracker
+        {
+        public:
+            /*Heap allocations made by the calling thread since it started*/
+            static uint64_t ThreadAllocations();
+
+            /*Bytes requested by those allocations*/
+            static uint64_t ThreadAllocatedBytes();
+
+            /*Heap allocations made by all threads since startup*/
+            static uint64_t TotalAllocations();
+
+            static uint64_t TotalAllocatedBytes();
+
+            static bool     Enabled();
+        };
+
+        /*
+        * Reports (and optionally asserts) if any thread allocates between
+        * construction and destruction of the guard: the frame thread, job
+        * workers, the render thread or the streaming threads.
+        */
+        class HT_API FrameAllocationGuard
+        {
+        public:
+            FrameAllocationGuard(bool armed, bool assertOnAllocation);
+
+            ~FrameAllocationGuard();
+
+        private:
+            uint64_t m_allocations;
+            uint64_t m_bytes;
+            uint64_t m_threadAllocations;
+            bool     m_armed;
+            bool     m_assert;
+        };
+
+    }
+
+}
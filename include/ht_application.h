@@ -16,6 +16,18 @@
 
 #include <ht_platform.h>
 #include <ht_inireader.h>
+#include <ht_frame_arena.h>
+#include <ht_frame_pacer.h>
+#include <ht_event.h>
+#include <ht_render_command_buffer.h>
+#include <ht_startup_trace.h>
+#include <ht_window.h>
+#include <ht_settings_singleton.h>
+#include <ht_world.h>
+#include <ht_transform_hierarchy.h>
+#include <ht_broadphase.h>
+
+#include <string>
 
 namespace Hatchit {
 
@@ -24,16 +36,79 @@ namespace Hatchit {
         class HT_API Application
         {
         public:
-            Application(Core::INIReader* settings);
+            /*With a settings path, edits to that file are applied while running*/
+            Application(Core::INIReader* settings, const std::string& settingsPath = std::string());
 
             int Run();
+
+            FrameArena& Arena();
+
+            World& Entities();
+
+            TransformHierarchy& Transforms();
+
+            Broadphase& Spatial();
             
         private:
             bool Initialize();
 
+            bool InitializeMainThread(const WindowParams& wparams, Graphics::RendererParams& rparams, uint32_t eventCapacity);
+
+            void ReportStartup();
+
+            void LoadSettings(const SettingsSnapshot& settings);
+
+            void ApplySettings(const SettingsSnapshot& settings);
+
             void DeInitialize();
+
+            void Update();
+
+            void PublishRenderView();
+
+            void SetBackground(bool background);
+
+            bool ResizeDue();
+
+            void ApplyPendingResize(RenderCommandBuffer& commands);
+
+            uint32_t EventWaitTimeout();
+
+            static void OnWindowResized(const Event* events, uint32_t count, void* userData);
         private:
-            Core::INIReader* m_settings;
+            Core::INIReader*    m_settings;
+            std::string         m_settingsPath;
+            uint32_t            m_settingsVersion;
+            int                 m_workerCount;
+            FrameArena          m_frameArena;
+            World               m_world;
+            TransformHierarchy  m_transforms;
+            Broadphase          m_broadphase;
+            uint32_t            m_allocationWarmupFrames;
+            bool                m_assertNoFrameAllocations;
+            float               m_clearColor[4];
+            uint32_t            m_updateRate;
+            uint32_t            m_maxUpdateSteps;
+            float               m_targetFPS;
+            uint32_t            m_spinMicroseconds;
+            PacingMode          m_pacing;
+            float               m_backgroundFPS;
+            bool                m_throttleUnfocused;
+            bool                m_background;
+            bool                m_eventDriven;
+            uint32_t            m_eventTimeoutMs;
+            bool                m_eventArrived;
+            uint32_t            m_resizeSubscription;
+            bool                m_resizePending;
+            uint32_t            m_resizeWidth;
+            uint32_t            m_resizeHeight;
+            uint64_t            m_resizeTick;
+            uint64_t            m_resizeDebounceTicks;
+            uint64_t            m_streamingBudgetTicks;
+            StartupTrace        m_startupTrace;
+            uint32_t            m_firstFramePhase;
+            std::string         m_startupReportPath;
+            bool                m_printStartup;
         };
 
 
@@ -0,0 +1,99 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+
+#pragma once
+
+#include <ht_platform.h>
+#include <ht_entity.h>
+
+#include <vector>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        /*
+        * All entities with exactly one component set. Rows live in fixed-size
+        * chunks laid out as structure-of-arrays: the entity handles, then one
+        * cache-line aligned column per component. Chunks are kept dense, so
+        * every chunk but the last in use is full.
+        */
+        class HT_API Archetype
+        {
+        public:
+            static const uint32_t CHUNK_SIZE = 16 * 1024;
+            static const uint32_t COLUMN_ALIGNMENT = 64;
+
+            struct Chunk
+            {
+                uint8_t*    memory;
+                uint8_t*    data;
+                uint32_t    count;
+            };
+
+            Archetype(ComponentMask mask);
+
+            ~Archetype();
+
+            ComponentMask Mask() const { return m_mask; }
+
+            bool          Has(ComponentId id) const { return ((m_mask >> id) & 1) != 0; }
+
+            uint32_t      ChunkCount() const { return m_usedChunks; }
+
+            uint32_t      ChunkCapacity() const { return m_capacity; }
+
+            uint32_t      EntityCount() const { return m_entityCount; }
+
+            Chunk&        GetChunk(uint32_t index) { return m_chunks[index]; }
+
+            Entity*       Entities(const Chunk& chunk) const { return reinterpret_cast<Entity*>(chunk.data); }
+
+            void*         Column(const Chunk& chunk, ComponentId id) const { return chunk.data + m_offsets[id]; }
+
+            void*         Component(uint32_t chunk, uint32_t row, ComponentId id) const;
+
+            /*Adds a row with uninitialized components and returns where it went*/
+            void          Append(Entity entity, uint32_t& chunk, uint32_t& row);
+
+            /*
+            * Fills the row with the last row and shrinks by one. Returns the
+            * entity that moved into the row, or NULL_ENTITY if none did.
+            */
+            Entity        RemoveSwap(uint32_t chunk, uint32_t row);
+
+        private:
+            friend class World;
+
+            uint32_t      Layout(uint32_t capacity);
+
+            ComponentMask       m_mask;
+            ComponentId         m_components[MAX_COMPONENTS];
+            uint32_t            m_componentCount;
+            uint32_t            m_offsets[MAX_COMPONENTS];
+            uint32_t            m_capacity;
+            uint32_t            m_chunkBytes;
+            std::vector<Chunk>  m_chunks;
+            uint32_t            m_usedChunks;
+            uint32_t            m_entityCount;
+
+            /*Neighbours with one component more or less, cached by the World*/
+            Archetype*          m_addEdges[MAX_COMPONENTS];
+            Archetype*          m_removeEdges[MAX_COMPONENTS];
+        };
+
+    }
+
+}
@@ -0,0 +1,113 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+
+#pragma once
+
+#include <ht_platform.h>
+#include <ht_singleton.h>
+#include <ht_pack_file.h>
+#include <ht_mpmc_queue.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        /*
+        * A finished load as handed to its callback. Uncompressed entries
+        * point straight into the mapped pack and stay valid while it is
+        * mounted; decompressed ones live in buffer, which the callback may
+        * move out to keep. Anything left in buffer is freed afterwards.
+        */
+        struct HT_API StreamedAsset
+        {
+            uint64_t                id;
+            const uint8_t*          data;
+            size_t                  size;
+            bool                    loaded;
+            std::vector<uint8_t>    buffer;
+        };
+
+        typedef void (*AssetCallback)(StreamedAsset& asset, void* userData);
+
+        /*
+        * Loads pack entries off the main thread. Streaming threads of their
+        * own fault in mapped pages and decompress, so a long load never runs
+        * inside a job the main thread helps with. Callbacks are delivered on
+        * the main thread by Dispatch, within a time budget per call.
+        */
+        class HT_API AssetStreamer : public Core::Singleton<AssetStreamer>
+        {
+        public:
+            AssetStreamer();
+
+            static bool     Initialize(uint32_t threadCount, uint32_t capacity);
+
+            static void     DeInitialize();
+
+            /*Later mounts shadow entries of earlier ones with the same id*/
+            static bool     Mount(const std::string& path);
+
+            static bool     Contains(const std::string& name);
+
+            static bool     Contains(uint64_t id);
+
+            /*Fails if no mounted pack has the entry or capacity loads are already in flight*/
+            static bool     Load(const std::string& name, AssetCallback callback, void* userData);
+
+            static bool     Load(uint64_t id, AssetCallback callback, void* userData);
+
+            /*Runs finished callbacks until budgetTicks pass (at least one); returns how many ran*/
+            static uint32_t Dispatch(uint64_t budgetTicks);
+
+            static uint32_t Pending();
+
+        private:
+            struct Request
+            {
+                const PackFile*     pack;
+                const PackEntry*    entry;
+                AssetCallback       callback;
+                void*               userData;
+                StreamedAsset       asset;
+            };
+
+            static const PackEntry* Find(uint64_t id, const PackFile*& pack);
+
+            static void     WorkerMain();
+
+            static void     Process(Request* request);
+
+            std::vector<PackFile*>      m_packs;
+            std::vector<Request>        m_requests;
+            std::vector<Request*>       m_free;
+            MPMCQueue<Request*>         m_queued;
+            MPMCQueue<Request*>         m_completed;
+            std::vector<std::thread>    m_workers;
+            std::mutex                  m_lock;
+            std::condition_variable     m_wake;
+            uint32_t                    m_available;
+            bool                        m_stopping;
+        };
+
+    }
+
+}
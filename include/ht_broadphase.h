@@ -0,0 +1,181 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+
+#pragma once
+
+#include <ht_platform.h>
+
+#include <vector>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        typedef uint32_t ProxyId;
+
+        struct HT_API Bounds
+        {
+            float min[3];
+            float max[3];
+        };
+
+        /*Overlapping proxies, a < b*/
+        struct HT_API ProxyPair
+        {
+            ProxyId a;
+            ProxyId b;
+        };
+
+        struct HT_API RayHit
+        {
+            ProxyId proxy;
+            float   distance;
+        };
+
+        struct HT_API BroadphaseParams
+        {
+            float       origin[3];
+            float       cellSize;
+            uint32_t    cells[3];
+        };
+
+        /*
+        * Loose uniform grid for dynamic objects. Each proxy lives in the one
+        * cell holding its center, so a cell's contents may spill up to half a
+        * cell into its neighbours; queries widen their search by that margin.
+        * Proxies larger than a cell or centered outside the grid are kept in
+        * a short list that every query also checks.
+        *
+        * Insert, Move and Remove write straight into per-proxy bounds. Update
+        * re-sorts proxies into cells (one counting sort) and finds every
+        * overlapping pair across the job system; queries and Pairs() see the
+        * state of the last Update. Queries are const and may run in parallel;
+        * Move may be called from jobs for distinct proxies.
+        */
+        class HT_API Broadphase
+        {
+        public:
+            static const ProxyId  INVALID = 0xFFFFFFFF;
+
+            /*Occupied cells per pair-finding job*/
+            static const uint32_t PAIR_BATCH = 256;
+
+            static const uint32_t MAX_CELLS = 1 << 22;
+
+            Broadphase();
+
+            /*Takes effect on the next Update; proxies are kept. Fails on an empty or oversized grid*/
+            bool        Configure(const BroadphaseParams& params);
+
+            void        Reserve(uint32_t count);
+
+            ProxyId     Insert(const Bounds& bounds);
+
+            void        Insert(const Bounds* bounds, uint32_t count, ProxyId* ids);
+
+            void        Move(ProxyId id, const Bounds& bounds);
+
+            void        Move(const ProxyId* ids, const Bounds* bounds, uint32_t count);
+
+            /*The id is recycled once the next Update drops it from the grid*/
+            void        Remove(ProxyId id);
+
+            void        Remove(const ProxyId* ids, uint32_t count);
+
+            const Bounds& GetBounds(ProxyId id) const;
+
+            void        Update();
+
+            /*
+            * Queries write up to capacity results and return the total found,
+            * so a caller can retry with a larger buffer.
+            */
+            uint32_t    QueryAABB(const Bounds& bounds, ProxyId* results, uint32_t capacity) const;
+
+            uint32_t    QueryRadius(const float center[3], float radius, ProxyId* results, uint32_t capacity) const;
+
+            /*Hits are unordered; distance is along the normalized direction*/
+            uint32_t    QueryRay(const float origin[3], const float direction[3], float maxDistance,
+                                 RayHit* results, uint32_t capacity) const;
+
+            const ProxyPair* Pairs() const;
+
+            uint32_t    PairCount() const;
+
+            uint32_t    Count() const;
+
+        private:
+            enum Channel
+            {
+                MIN_X,
+                MIN_Y,
+                MIN_Z,
+                MAX_X,
+                MAX_Y,
+                MAX_Z,
+                CHANNEL_COUNT
+            };
+
+            bool        Alive(ProxyId id) const;
+
+            void        Rebuild();
+
+            void        Bin(ProxyId id);
+
+            void        FindPairs();
+
+            void        FindCellPairs(uint32_t cell, std::vector<ProxyPair>& pairs) const;
+
+            bool        CellRange(const Bounds& bounds, float margin, uint32_t lo[3], uint32_t hi[3]) const;
+
+            template <typename Test>
+            void        VisitCell(uint32_t cell, Test& test) const;
+
+            template <typename Test>
+            void        VisitCells(const uint32_t lo[3], const uint32_t hi[3], Test& test) const;
+
+            static void FindPairsBatch(uint32_t begin, uint32_t end, void* data);
+
+            BroadphaseParams                    m_requested;
+            BroadphaseParams                    m_params;
+            float                               m_inverseCellSize;
+            uint32_t                            m_cellCount;
+
+            /*Per proxy, written by Insert/Move/Remove*/
+            std::vector<Bounds>                 m_bounds;
+            std::vector<uint8_t>                m_alive;
+            std::vector<ProxyId>                m_freeIds;
+            std::vector<ProxyId>                m_removed;
+            uint32_t                            m_count;
+
+            /*Grid built by Update: proxies sorted by cell, bounds as SoA*/
+            std::vector<uint32_t>               m_cellStart;
+            std::vector<uint32_t>               m_occupied;
+            std::vector<float>                  m_sorted[CHANNEL_COUNT];
+            std::vector<ProxyId>                m_sortedIds;
+            std::vector<uint32_t>               m_cellOf;
+            std::vector<ProxyId>                m_order;
+
+            std::vector<ProxyId>                m_oversize;
+            std::vector<Bounds>                 m_oversizeBounds;
+
+            /*One pair list per job batch, concatenated in order so results are deterministic*/
+            std::vector<std::vector<ProxyPair>> m_batchPairs;
+            std::vector<ProxyPair>              m_pairs;
+        };
+
+    }
+
+}
@@ -0,0 +1,108 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+
+#pragma once
+
+#include <ht_platform.h>
+
+#include <type_traits>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        typedef uint32_t ComponentId;
+
+        typedef uint64_t ComponentMask;
+
+        static const uint32_t MAX_COMPONENTS = 64;
+
+        /*
+        * Index into the world's entity table plus the generation it was
+        * created with, so handles to destroyed entities stop matching.
+        */
+        struct HT_API Entity
+        {
+            uint32_t index;
+            uint32_t generation;
+
+            bool operator==(const Entity& other) const { return index == other.index && generation == other.generation; }
+            bool operator!=(const Entity& other) const { return !(*this == other); }
+        };
+
+        static const Entity NULL_ENTITY = { 0xFFFFFFFF, 0 };
+
+        struct HT_API ComponentInfo
+        {
+            uint32_t size;
+            uint32_t alignment;
+        };
+
+        /*
+        * Hands out a dense id per component type on first use. Components
+        * live in raw chunk memory and are moved with memcpy, so they must be
+        * trivially copyable.
+        */
+        class HT_API ComponentRegistry
+        {
+        public:
+            template <typename T>
+            static ComponentId Id()
+            {
+                static_assert(std::is_trivially_copyable<T>::value, "Components must be trivially copyable");
+
+                static const ComponentId id = Register(sizeof(T), alignof(T));
+                return id;
+            }
+
+            static uint32_t Count();
+
+            static const ComponentInfo& Info(ComponentId id);
+
+        private:
+            static ComponentId Register(uint32_t size, uint32_t alignment);
+        };
+
+        template <typename... T>
+        ComponentMask MaskOf()
+        {
+            const ComponentMask bits[] = { 0, (ComponentMask(1) << ComponentRegistry::Id<T>())... };
+
+            ComponentMask mask = 0;
+            for (ComponentMask bit : bits)
+                mask |= bit;
+            return mask;
+        }
+
+        /*C++11 stand-in for std::index_sequence, used to expand per-column pointers*/
+        template <uint32_t... I>
+        struct IndexSequence
+        {
+        };
+
+        template <uint32_t N, uint32_t... I>
+        struct MakeIndexSequence : MakeIndexSequence<N - 1, N - 1, I...>
+        {
+        };
+
+        template <uint32_t... I>
+        struct MakeIndexSequence<0, I...>
+        {
+            typedef IndexSequence<I...> Type;
+        };
+
+    }
+
+}
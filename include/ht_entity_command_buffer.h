@@ -0,0 +1,92 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+
+#pragma once
+
+#include <ht_platform.h>
+#include <ht_entity.h>
+
+#include <vector>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        /*
+        * Structural changes recorded while iterating, applied later with
+        * World::Playback. Entities returned by Create are placeholders that
+        * only mean something to later commands in the same buffer.
+        */
+        class HT_API EntityCommandBuffer
+        {
+        public:
+            EntityCommandBuffer();
+
+            Entity   Create();
+
+            void     Destroy(Entity entity);
+
+            template <typename T>
+            void     Add(Entity entity, const T& component)
+            {
+                AddRaw(entity, ComponentRegistry::Id<T>(), &component, sizeof(T));
+            }
+
+            template <typename T>
+            void     Remove(Entity entity)
+            {
+                RemoveRaw(entity, ComponentRegistry::Id<T>());
+            }
+
+            void     AddRaw(Entity entity, ComponentId id, const void* data, uint32_t size);
+
+            void     RemoveRaw(Entity entity, ComponentId id);
+
+            uint32_t Count() const;
+
+            void     Reset();
+
+        private:
+            friend class World;
+
+            enum class CommandType : uint32_t
+            {
+                CREATE,
+                DESTROY,
+                ADD,
+                REMOVE
+            };
+
+            struct CommandHeader
+            {
+                CommandType type;
+                ComponentId component;
+                Entity      entity;
+                uint32_t    size;
+                uint32_t    stride;
+            };
+
+            static const uint32_t PLACEHOLDER_BIT = 0x80000000;
+
+            void     Write(CommandType type, Entity entity, ComponentId id, const void* data, uint32_t size);
+
+            std::vector<uint8_t>    m_data;
+            uint32_t                m_count;
+            uint32_t                m_created;
+        };
+
+    }
+
+}
@@ -0,0 +1,110 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#pragma once
+
+#include <ht_platform.h>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        enum class EventType : uint8_t
+        {
+            QUIT,
+            WINDOW_SHOWN,
+            WINDOW_HIDDEN,
+            WINDOW_EXPOSED,
+            WINDOW_MOVED,
+            WINDOW_RESIZED,
+            WINDOW_MINIMIZED,
+            WINDOW_MAXIMIZED,
+            WINDOW_RESTORED,
+            WINDOW_MOUSE_ENTER,
+            WINDOW_MOUSE_LEAVE,
+            WINDOW_FOCUS_GAINED,
+            WINDOW_FOCUS_LOST,
+            WINDOW_CLOSE,
+            KEY,
+            MOUSE_MOTION,
+            MOUSE_BUTTON,
+            MOUSE_WHEEL,
+            CONTROLLER_ADDED,
+            CONTROLLER_REMOVED,
+            CONTROLLER_BUTTON,
+            CONTROLLER_AXIS,
+            USER,
+            COUNT
+        };
+
+        struct HT_API WindowEventData
+        {
+            int32_t  x;
+            int32_t  y;
+        };
+
+        struct HT_API KeyEventData
+        {
+            uint16_t scancode;
+            uint16_t modifiers;
+            uint8_t  down;
+            uint8_t  repeat;
+        };
+
+        struct HT_API MouseEventData
+        {
+            int32_t  x;
+            int32_t  y;
+            int16_t  dx;
+            int16_t  dy;
+            uint8_t  button;
+            uint8_t  clicks;
+            uint8_t  down;
+        };
+
+        struct HT_API ControllerEventData
+        {
+            int32_t  id;
+            int16_t  value;
+            uint8_t  control;
+        };
+
+        struct HT_API UserEventData
+        {
+            int32_t  code;
+            uint32_t value;
+        };
+
+        /*
+        * Compact, trivially copyable engine event. Backends translate their
+        * native events into these; the payload member in use depends on type.
+        * Press and release share a type so a batch keeps their relative order.
+        */
+        struct HT_API Event
+        {
+            EventType type;
+            uint32_t  timestamp;
+            union
+            {
+                WindowEventData     window;
+                KeyEventData        key;
+                MouseEventData      mouse;
+                ControllerEventData controller;
+                UserEventData       user;
+            };
+        };
+
+    }
+
+}
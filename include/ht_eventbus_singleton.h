@@ -0,0 +1,79 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#pragma once
+
+#include <ht_platform.h>
+#include <ht_singleton.h>
+#include <ht_event.h>
+#include <ht_mpmc_queue.h>
+
+#include <vector>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        /*Receives every event of one type from a frame as a single contiguous batch*/
+        typedef void (*EventHandler)(const Event* events, uint32_t count, void* userData);
+
+        /*
+        * Per-frame event bus. The window publishes translated events on the
+        * main thread, other threads may Post through a lock-free queue, and
+        * Dispatch hands each subscriber all events of its type in one call.
+        */
+        class HT_API EventBus : public Core::Singleton<EventBus>
+        {
+        public:
+            static bool     Initialize(uint32_t capacity);
+
+            static void     DeInitialize();
+
+            static uint32_t Subscribe(EventType type, EventHandler handler, void* userData);
+
+            static void     Unsubscribe(uint32_t id);
+
+            static void     Publish(const Event& event);
+
+            static bool     Post(const Event& event);
+
+            static void     Dispatch();
+
+            /*Events published since the last Dispatch, not including posted ones*/
+            static const Event* PublishedEvents(uint32_t& count);
+
+            /*Events from the last Dispatch, grouped by type. Read-only until the next Dispatch.*/
+            static const Event* DispatchedEvents(uint32_t& count);
+
+        private:
+            static const uint32_t TYPE_COUNT = static_cast<uint32_t>(EventType::COUNT);
+
+            struct Subscription
+            {
+                uint32_t     id;
+                EventHandler handler;
+                void*        userData;
+            };
+
+            std::vector<Event>          m_pending;
+            std::vector<Event>          m_dispatched;
+            std::vector<Subscription>   m_subscriptions[TYPE_COUNT];
+            uint32_t                    m_offsets[TYPE_COUNT + 1];
+            uint32_t                    m_nextId;
+            MPMCQueue<Event>            m_posted;
+        };
+
+    }
+
+}
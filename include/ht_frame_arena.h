@@ -0,0 +1,147 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#pragma once
+
+#include <ht_platform.h>
+
+#include <atomic>
+#include <new>
+#include <vector>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        /*
+        * Bump allocator over a single fixed block. Allocation is a pointer
+        * bump (safe from any thread); memory is only ever released all at
+        * once through Reset.
+        */
+        class HT_API LinearAllocator
+        {
+        public:
+            LinearAllocator();
+
+            ~LinearAllocator();
+
+            bool   Initialize(size_t capacity);
+
+            void   DeInitialize();
+
+            void*  Allocate(size_t size, size_t alignment);
+
+            void   Reset();
+
+            size_t Used() const;
+
+            size_t Capacity() const;
+
+            size_t HighWaterMark() const;
+
+            size_t FailedAllocations() const;
+
+        private:
+            LinearAllocator(const LinearAllocator&);
+            LinearAllocator& operator=(const LinearAllocator&);
+
+            uint8_t*            m_buffer;
+            size_t              m_capacity;
+            std::atomic<size_t> m_offset;
+            std::atomic<size_t> m_failed;
+            size_t              m_highWaterMark;
+        };
+
+        /*
+        * Two linear allocators used on alternate frames. Memory handed out
+        * during frame N stays valid until the start of frame N + 2, so data
+        * recorded in one frame can still be consumed during the next.
+        */
+        class HT_API FrameArena
+        {
+        public:
+            FrameArena();
+
+            bool   Initialize(size_t capacityPerFrame);
+
+            void   DeInitialize();
+
+            void   NextFrame();
+
+            void*  Allocate(size_t size, size_t alignment);
+
+            template <typename T>
+            T*     Allocate(size_t count);
+
+            LinearAllocator& Current();
+
+            size_t HighWaterMark() const;
+
+            size_t Capacity() const;
+
+            size_t FailedAllocations() const;
+
+        private:
+            LinearAllocator m_allocators[2];
+            uint32_t        m_current;
+        };
+
+        /*STL-compatible adaptor. Deallocation is a no-op; memory is reclaimed on reset.*/
+        template <typename T>
+        class ArenaAllocator
+        {
+        public:
+            typedef T value_type;
+
+            ArenaAllocator(LinearAllocator& allocator) : m_allocator(&allocator) { }
+
+            template <typename U>
+            ArenaAllocator(const ArenaAllocator<U>& other) : m_allocator(other.m_allocator) { }
+
+            T* allocate(size_t n)
+            {
+                void* p = m_allocator->Allocate(n * sizeof(T), alignof(T));
+                if (!p)
+                    throw std::bad_alloc();
+
+                return static_cast<T*>(p);
+            }
+
+            void deallocate(T*, size_t) { }
+
+            template <typename U>
+            bool operator==(const ArenaAllocator<U>& other) const { return m_allocator == other.m_allocator; }
+
+            template <typename U>
+            bool operator!=(const ArenaAllocator<U>& other) const { return m_allocator != other.m_allocator; }
+
+        private:
+            template <typename U>
+            friend class ArenaAllocator;
+
+            LinearAllocator* m_allocator;
+        };
+
+        template <typename T>
+        using FrameVector = std::vector<T, ArenaAllocator<T>>;
+
+        template <typename T>
+        T* FrameArena::Allocate(size_t count)
+        {
+            return static_cast<T*>(Allocate(count * sizeof(T), alignof(T)));
+        }
+
+    }
+
+}
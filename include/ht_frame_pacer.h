@@ -0,0 +1,85 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#pragma once
+
+#include <ht_platform.h>
+
+#include <atomic>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        enum class PacingMode
+        {
+            FIXED,
+            PRESENT
+        };
+
+        /*
+        * Frame-rate limiter. Sleeps for the bulk of the remaining frame time
+        * and spins for the final spinTicks, which keeps wake-up error well
+        * under 100us without burning a core. In PRESENT mode the period stays
+        * fixed and only the phase follows the display: each deadline is set
+        * so the next present lands one period after the last observed one.
+        * The measured present interval is reported, never used as the period.
+        */
+        class HT_API FramePacer
+        {
+        public:
+            static const uint32_t HISTOGRAM_BUCKETS = 8;
+
+            FramePacer();
+
+            void     Configure(uint64_t periodTicks, uint64_t spinTicks, PacingMode mode);
+
+            void     Reset();
+
+            bool     Enabled() const;
+
+            void     Wait();
+
+            void     RecordPresent(uint64_t now);
+
+            uint64_t PresentInterval() const;
+
+            uint64_t HistogramCount(uint32_t bucket) const;
+
+            uint64_t HistogramUpperBound(uint32_t bucket) const;
+
+            uint64_t MaxError() const;
+
+            double   MeanError() const;
+
+            void     Dump() const;
+
+        private:
+            uint64_t                m_period;
+            uint64_t                m_spin;
+            PacingMode              m_mode;
+            uint64_t                m_deadline;
+            uint64_t                m_lastWake;
+            uint64_t                m_latency;
+            uint64_t                m_histogram[HISTOGRAM_BUCKETS];
+            uint64_t                m_samples;
+            uint64_t                m_errorSum;
+            uint64_t                m_errorMax;
+            std::atomic<uint64_t>   m_lastPresent;
+            std::atomic<uint64_t>   m_presentInterval;
+        };
+
+    }
+
+}
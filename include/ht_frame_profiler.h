@@ -0,0 +1,95 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#pragma once
+
+#include <ht_platform.h>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        enum class FramePhase
+        {
+            TICK,
+            EVENTS,
+            UPDATE,
+            TRANSFORM,
+            RECORD,
+            SUBMIT,
+            SWAP,
+            PACE,
+            COUNT
+        };
+
+        /*
+        * Fixed-size ring buffer of per-frame phase timings in nanoseconds.
+        * Never allocates, so it is safe to keep enabled in release builds.
+        */
+        class HT_API FrameProfiler
+        {
+        public:
+            static const uint32_t HISTORY_SIZE = 512;
+            static const uint32_t PHASE_COUNT = static_cast<uint32_t>(FramePhase::COUNT);
+
+            FrameProfiler();
+
+            void     Reset();
+
+            void     BeginFrame(uint64_t now);
+
+            void     RecordPhase(FramePhase phase, uint64_t nanoseconds);
+
+            uint32_t SampleCount() const;
+
+            uint64_t FrameTimePercentile(float percentile) const;
+
+            uint64_t PhaseTimePercentile(FramePhase phase, float percentile) const;
+
+            uint64_t MaxFrameTime() const;
+
+            void     Dump() const;
+
+        private:
+            struct FrameSample
+            {
+                uint64_t total;
+                uint64_t phases[PHASE_COUNT];
+            };
+
+            uint64_t Percentile(int phase, float percentile) const;
+
+            FrameSample         m_history[HISTORY_SIZE];
+            FrameSample         m_current;
+            uint64_t            m_frameStart;
+            uint32_t            m_head;
+            uint32_t            m_count;
+            mutable uint64_t    m_scratch[HISTORY_SIZE];
+        };
+
+        class HT_API ScopedFramePhase
+        {
+        public:
+            ScopedFramePhase(FramePhase phase);
+
+            ~ScopedFramePhase();
+
+        private:
+            FramePhase m_phase;
+            uint64_t   m_start;
+        };
+
+    }
+
+}
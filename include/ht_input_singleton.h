@@ -0,0 +1,192 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#pragma once
+
+#include <ht_platform.h>
+#include <ht_singleton.h>
+#include <ht_event.h>
+
+#include <bitset>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        /*Physical key positions, numbered like USB HID usage codes (and SDL scancodes)*/
+        enum class Key : uint16_t
+        {
+            A = 4, B, C, D, E, F, G, H, I, J, K, L, M,
+            N, O, P, Q, R, S, T, U, V, W, X, Y, Z,
+            NUM_1, NUM_2, NUM_3, NUM_4, NUM_5, NUM_6, NUM_7, NUM_8, NUM_9, NUM_0,
+            RETURN = 40,
+            ESCAPE,
+            BACKSPACE,
+            TAB,
+            SPACE,
+            F1 = 58, F2, F3, F4, F5, F6, F7, F8, F9, F10, F11, F12,
+            RIGHT = 79,
+            LEFT,
+            DOWN,
+            UP,
+            LCTRL = 224,
+            LSHIFT,
+            LALT,
+            LGUI,
+            RCTRL,
+            RSHIFT,
+            RALT,
+            RGUI
+        };
+
+        enum class MouseButton : uint8_t
+        {
+            LEFT = 1,
+            MIDDLE,
+            RIGHT,
+            X1,
+            X2
+        };
+
+        enum class ControllerButton : uint8_t
+        {
+            A,
+            B,
+            X,
+            Y,
+            BACK,
+            GUIDE,
+            START,
+            LEFT_STICK,
+            RIGHT_STICK,
+            LEFT_SHOULDER,
+            RIGHT_SHOULDER,
+            DPAD_UP,
+            DPAD_DOWN,
+            DPAD_LEFT,
+            DPAD_RIGHT
+        };
+
+        enum class ControllerAxis : uint8_t
+        {
+            LEFT_X,
+            LEFT_Y,
+            RIGHT_X,
+            RIGHT_Y,
+            TRIGGER_LEFT,
+            TRIGGER_RIGHT
+        };
+
+        /*
+        * Complete input state for one frame. Held bits are the state at the
+        * end of the frame; pressed/released bits record every edge seen
+        * during it, so a tap shorter than a frame is not lost.
+        */
+        struct HT_API InputState
+        {
+            static const uint32_t KEY_COUNT = 512;
+            static const uint32_t MOUSE_BUTTON_COUNT = 8;
+            static const uint32_t CONTROLLER_COUNT = 4;
+            static const uint32_t CONTROLLER_BUTTON_COUNT = 32;
+            static const uint32_t CONTROLLER_AXIS_COUNT = 6;
+
+            std::bitset<KEY_COUNT>                  keys;
+            std::bitset<KEY_COUNT>                  keysPressed;
+            std::bitset<KEY_COUNT>                  keysReleased;
+            std::bitset<MOUSE_BUTTON_COUNT>         mouseButtons;
+            std::bitset<MOUSE_BUTTON_COUNT>         mousePressed;
+            std::bitset<MOUSE_BUTTON_COUNT>         mouseReleased;
+            std::bitset<CONTROLLER_BUTTON_COUNT>    controllerButtons[CONTROLLER_COUNT];
+            std::bitset<CONTROLLER_BUTTON_COUNT>    controllerPressed[CONTROLLER_COUNT];
+            std::bitset<CONTROLLER_BUTTON_COUNT>    controllerReleased[CONTROLLER_COUNT];
+            int16_t                                 controllerAxes[CONTROLLER_COUNT][CONTROLLER_AXIS_COUNT];
+            int32_t                                 mouseX;
+            int32_t                                 mouseY;
+            int32_t                                 mouseDeltaX;
+            int32_t                                 mouseDeltaY;
+            int32_t                                 wheelX;
+            int32_t                                 wheelY;
+        };
+
+        /*
+        * Input snapshots built from the event bus. Events accumulate into a
+        * pending state during EventBus::Dispatch; Update publishes it as the
+        * current snapshot. Snapshots only change inside Update on the main
+        * thread, so queries are plain bit tests and are safe from job threads
+        * for the rest of the frame.
+        */
+        class HT_API Input : public Core::Singleton<Input>
+        {
+        public:
+            Input();
+
+            static bool  Initialize();
+
+            static void  DeInitialize();
+
+            static void  Update();
+
+            static bool  KeyHeld(Key key);
+
+            static bool  KeyPressed(Key key);
+
+            static bool  KeyReleased(Key key);
+
+            static bool  MouseButtonHeld(MouseButton button);
+
+            static bool  MouseButtonPressed(MouseButton button);
+
+            static bool  MouseButtonReleased(MouseButton button);
+
+            static void  MousePosition(int32_t& x, int32_t& y);
+
+            static void  MouseDelta(int32_t& dx, int32_t& dy);
+
+            static void  MouseWheel(int32_t& x, int32_t& y);
+
+            static bool  ControllerButtonHeld(uint32_t controller, ControllerButton button);
+
+            static bool  ControllerButtonPressed(uint32_t controller, ControllerButton button);
+
+            static bool  ControllerButtonReleased(uint32_t controller, ControllerButton button);
+
+            static float ControllerAxisValue(uint32_t controller, ControllerAxis axis);
+
+            static const InputState& Current();
+
+            static const InputState& Previous();
+
+        private:
+            static void OnKey(const Event* events, uint32_t count, void* userData);
+
+            static void OnMouse(const Event* events, uint32_t count, void* userData);
+
+            static void OnController(const Event* events, uint32_t count, void* userData);
+
+            /*Slot a controller instance id occupies, claiming a free one if allowed; CONTROLLER_COUNT if none*/
+            static uint32_t ControllerSlot(int32_t id, bool claim);
+
+            static const int32_t FREE_SLOT = -1;
+
+            InputState  m_pending;
+            InputState  m_current;
+            InputState  m_previous;
+            int32_t     m_controllerIds[InputState::CONTROLLER_COUNT];
+            uint32_t    m_subscriptions[16];
+            uint32_t    m_subscriptionCount;
+        };
+
+    }
+
+}
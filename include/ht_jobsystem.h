@@ -0,0 +1,115 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#pragma once
+
+#include <ht_platform.h>
+#include <ht_singleton.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        typedef void (*JobFunction)(void* data);
+
+        typedef void (*ParallelForFunction)(uint32_t begin, uint32_t end, void* data);
+
+        /*
+        * Counts outstanding jobs. Run adds to it, each finished job
+        * subtracts one, and a counter at zero means all of its work is done.
+        */
+        class HT_API JobCounter
+        {
+        public:
+            JobCounter();
+
+            int32_t Value() const;
+
+        private:
+            friend class JobSystem;
+
+            std::atomic<int32_t> m_value;
+        };
+
+        /*
+        * A job is a plain function pointer and its argument. If dependency
+        * is set the job is not started until that counter reaches zero, so
+        * queue the jobs it depends on first.
+        */
+        struct HT_API Job
+        {
+            JobFunction function;
+            void*       data;
+            JobCounter* dependency;
+        };
+
+        class JobQueue;
+        struct QueuedJob;
+
+        /*
+        * Work-stealing job system. Every thread (the main thread is index 0)
+        * owns a deque: the owner pushes and pops at the back, idle threads
+        * steal from the front. Wait lets the calling thread help with queued
+        * work instead of blocking.
+        */
+        class HT_API JobSystem : public Core::Singleton<JobSystem>
+        {
+        public:
+            /*Initialize clamps the worker count to this*/
+            static const uint32_t MAX_WORKERS = 64;
+
+            JobSystem();
+
+            static bool     Initialize(int workerCount);
+
+            static void     DeInitialize();
+
+            static void     Run(const Job* jobs, uint32_t count, JobCounter* counter);
+
+            static void     Run(JobFunction function, void* data, JobCounter* counter);
+
+            static void     Wait(JobCounter* counter);
+
+            static void     ParallelFor(uint32_t count, uint32_t batchSize, ParallelForFunction function, void* data);
+
+            static uint32_t ThreadCount();
+
+            static uint32_t ThreadIndex();
+
+        private:
+            static void     WorkerMain(uint32_t index);
+
+            static bool     FindJob(uint32_t index, QueuedJob& job);
+
+            static void     Execute(uint32_t index, const QueuedJob& job);
+
+            JobQueue*                m_queues;
+            uint32_t                 m_queueCount;
+            std::vector<std::thread> m_workers;
+            std::atomic<int32_t>     m_pending;
+            std::atomic<int32_t>     m_sleeping;
+            std::atomic<bool>        m_shutdown;
+            std::mutex               m_sleepMutex;
+            std::condition_variable  m_wake;
+        };
+
+    }
+
+}
@@ -0,0 +1,48 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+
+#pragma once
+
+#include <ht_platform.h>
+
+#include <cstddef>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        /*
+        * LZ4 block format (no frame header or checksums). Decompress checks
+        * every length and offset against both buffers, so corrupt input
+        * fails instead of reading or writing out of bounds; bytes of dst past
+        * the decoded size may be used as scratch. Compress is a
+        * single-pass greedy matcher meant for offline packing.
+        */
+        class HT_API LZ4
+        {
+        public:
+            /*Worst-case compressed size of size input bytes*/
+            static size_t CompressBound(size_t size);
+
+            /*Returns the compressed size, or 0 if dst is too small*/
+            static size_t Compress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity);
+
+            /*Returns the decompressed size, or 0 on malformed input or overflow*/
+            static size_t Decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity);
+        };
+
+    }
+
+}
@@ -0,0 +1,169 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#pragma once
+
+#include <ht_platform.h>
+
+#include <atomic>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        /*
+        * Bounded lock-free multi-producer/multi-consumer queue (Vyukov).
+        * Capacity is rounded up to a power of two and allocated once in
+        * Initialize; Push and Pop never allocate and fail when full/empty.
+        */
+        template <typename T>
+        class MPMCQueue
+        {
+        public:
+            MPMCQueue();
+
+            ~MPMCQueue();
+
+            bool     Initialize(uint32_t capacity);
+
+            void     DeInitialize();
+
+            bool     Push(const T& value);
+
+            bool     Pop(T& value);
+
+            uint32_t Capacity() const;
+
+        private:
+            MPMCQueue(const MPMCQueue&);
+            MPMCQueue& operator=(const MPMCQueue&);
+
+            struct Cell
+            {
+                std::atomic<size_t> sequence;
+                T                   data;
+            };
+
+            Cell*                       m_cells;
+            size_t                      m_mask;
+            alignas(64) std::atomic<size_t> m_enqueue;
+            alignas(64) std::atomic<size_t> m_dequeue;
+        };
+
+        template <typename T>
+        MPMCQueue<T>::MPMCQueue()
+        {
+            m_cells = nullptr;
+            m_mask = 0;
+            m_enqueue = 0;
+            m_dequeue = 0;
+        }
+
+        template <typename T>
+        MPMCQueue<T>::~MPMCQueue()
+        {
+            DeInitialize();
+        }
+
+        template <typename T>
+        bool MPMCQueue<T>::Initialize(uint32_t capacity)
+        {
+            DeInitialize();
+
+            size_t size = 2;
+            while (size < capacity)
+                size <<= 1;
+
+            m_cells = new Cell[size];
+            for (size_t i = 0; i < size; i++)
+                m_cells[i].sequence.store(i, std::memory_order_relaxed);
+
+            m_mask = size - 1;
+            m_enqueue.store(0, std::memory_order_relaxed);
+            m_dequeue.store(0, std::memory_order_relaxed);
+
+            return true;
+        }
+
+        template <typename T>
+        void MPMCQueue<T>::DeInitialize()
+        {
+            delete[] m_cells;
+            m_cells = nullptr;
+            m_mask = 0;
+        }
+
+        template <typename T>
+        bool MPMCQueue<T>::Push(const T& value)
+        {
+            Cell* cell;
+            size_t pos = m_enqueue.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                cell = &m_cells[pos & m_mask];
+                size_t seq = cell->sequence.load(std::memory_order_acquire);
+                intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+                if (diff == 0)
+                {
+                    if (m_enqueue.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                    return false;
+                else
+                    pos = m_enqueue.load(std::memory_order_relaxed);
+            }
+
+            cell->data = value;
+            cell->sequence.store(pos + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        template <typename T>
+        bool MPMCQueue<T>::Pop(T& value)
+        {
+            Cell* cell;
+            size_t pos = m_dequeue.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                cell = &m_cells[pos & m_mask];
+                size_t seq = cell->sequence.load(std::memory_order_acquire);
+                intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+                if (diff == 0)
+                {
+                    if (m_dequeue.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                    return false;
+                else
+                    pos = m_dequeue.load(std::memory_order_relaxed);
+            }
+
+            value = cell->data;
+            cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        template <typename T>
+        uint32_t MPMCQueue<T>::Capacity() const
+        {
+            return static_cast<uint32_t>(m_mask + 1);
+        }
+
+    }
+
+}
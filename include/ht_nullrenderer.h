@@ -0,0 +1,70 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#pragma once
+
+#include <ht_platform.h>
+#include <ht_renderer.h>
+#include <ht_render_command_buffer.h>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        /*
+        * Renderer backend that accepts every call and draws nothing.
+        * Paired with NullWindow to measure CPU frame cost without a GPU.
+        * Calls are recorded as RenderCommands (last LOG_SIZE kept) and
+        * counted, so submission can be verified without a device.
+        */
+        class HT_API NullRenderer final : public Graphics::IRenderer
+        {
+        public:
+            NullRenderer();
+
+            ~NullRenderer();
+
+            bool VInitialize(const Graphics::RendererParams& params)   override;
+
+            void VDeInitialize()                                        override;
+
+            void VResizeBuffers(uint32_t width, uint32_t height)        override;
+
+            void VSetClearColor(const Graphics::Color& color)           override;
+
+            void VClearBuffer(Graphics::ClearArgs args)                 override;
+
+            void VPresent()                                             override;
+
+            static const uint32_t LOG_SIZE = 256;
+
+            uint64_t CallCount(RenderCommandType type) const;
+
+            uint32_t LoggedCount() const;
+
+            const RenderCommand& Logged(uint32_t index) const;
+
+            void     ResetLog();
+
+        private:
+            void Log(const RenderCommand& command);
+
+            RenderCommand m_log[LOG_SIZE];
+            uint64_t      m_total;
+            uint64_t      m_counts[4];
+        };
+
+    }
+
+}
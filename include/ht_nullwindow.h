@@ -0,0 +1,73 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#pragma once
+
+#include <ht_platform.h>
+#include <ht_window.h>
+
+#include <mutex>
+#include <condition_variable>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        /*
+        * Window backend with no display. Used for headless runs, where the
+        * loop closes itself after WindowParams::frameCount frames (0 = never).
+        */
+        class HT_API NullWindow final : public IWindow
+        {
+        public:
+            NullWindow(const WindowParams& params);
+
+            ~NullWindow();
+
+            bool    VInitialize()       override;
+
+            void*   VNativeHandle()     override;
+
+            bool    VIsRunning()        override;
+
+            void    VPollEvents()       override;
+
+            bool    VWaitEvents(uint32_t timeoutMs) override;
+
+            void    VWake()             override;
+
+            void    VClose()            override;
+
+            void    VSwapBuffers()      override;
+
+            void    VMakeContextCurrent(bool current) override;
+
+            bool    VIsVisible()        override;
+
+            bool    VHasFocus()         override;
+
+            void    VSetDisplayFPS(bool display) override;
+
+        private:
+            WindowParams        m_params;
+            uint32_t            m_frame;
+            bool                m_running;
+            bool                m_woken;
+            std::mutex              m_wakeLock;
+            std::condition_variable m_wakeSignal;
+        };
+
+    }
+
+}
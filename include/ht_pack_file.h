@@ -0,0 +1,145 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+
+#pragma once
+
+#include <ht_platform.h>
+
+#include <string>
+#include <vector>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        /*
+        * Pack layout: PackHeader, then entryCount PackEntry records sorted by
+        * id, then payloads, each starting on a multiple of the header's
+        * alignment. Ids are PackFile::Hash of the asset's path. All values
+        * are little-endian.
+        */
+        struct HT_API PackHeader
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t entryCount;
+            uint32_t alignment;
+        };
+
+        struct HT_API PackEntry
+        {
+            uint64_t id;
+            uint64_t offset;
+            uint32_t storedSize;
+            uint32_t size;
+            uint32_t flags;
+            uint32_t reserved;
+        };
+
+        /*
+        * Read-only, memory-mapped pack. Entry lookup is a binary search of
+        * the table of contents; stored bytes are read straight from the
+        * mapping, so uncompressed entries need no copy at all. A PackFile
+        * is safe to read from any number of threads once opened.
+        */
+        class HT_API PackFile
+        {
+        public:
+            static const uint32_t MAGIC = 0x4B505448;
+            static const uint32_t VERSION = 1;
+
+            /*PackEntry::flags*/
+            static const uint32_t COMPRESSED = 1;
+
+            /*LZ4 can't expand a block by more than this (plus a few bytes); larger sizes are corrupt*/
+            static const uint32_t MAX_EXPANSION = 255;
+
+            PackFile();
+
+            ~PackFile();
+
+            bool        Open(const std::string& path);
+
+            void        Close();
+
+            bool        IsOpen() const;
+
+            /*64-bit FNV-1a of an asset path*/
+            static uint64_t Hash(const std::string& name);
+
+            const PackEntry* Find(uint64_t id) const;
+
+            /*Stored bytes of the entry: the asset itself unless COMPRESSED*/
+            const uint8_t* Data(const PackEntry& entry) const;
+
+            /*Writes entry.size bytes to out, decompressing if needed*/
+            bool        Read(const PackEntry& entry, uint8_t* out) const;
+
+            /*Faults in the entry's pages so the caller's thread never stalls on them*/
+            void        Prefetch(const PackEntry& entry) const;
+
+            uint32_t    EntryCount() const;
+
+            const PackEntry* Entries() const;
+
+            const std::string& Path() const;
+
+        private:
+            PackFile(const PackFile&);
+            PackFile& operator=(const PackFile&);
+
+            bool        Map(const std::string& path);
+
+            void        Unmap();
+
+            std::string         m_path;
+            const uint8_t*      m_base;
+            size_t              m_size;
+            const PackEntry*    m_entries;
+            uint32_t            m_entryCount;
+#ifdef HT_SYS_WINDOWS
+            void*               m_file;
+            void*               m_mapping;
+#endif
+        };
+
+        /*Builds a pack in memory and writes it out; for tools and tests, not the runtime*/
+        class HT_API PackWriter
+        {
+        public:
+            PackWriter();
+
+            /*Compressed entries are stored raw when LZ4 does not make them smaller*/
+            bool        Add(const std::string& name, const void* data, size_t size, bool compress);
+
+            bool        Write(const std::string& path, uint32_t alignment = 64) const;
+
+            void        Clear();
+
+        private:
+            struct Item
+            {
+                uint64_t                id;
+                uint32_t                size;
+                uint32_t                flags;
+                std::vector<uint8_t>    stored;
+            };
+
+            std::vector<Item>   m_items;
+        };
+
+    }
+
+}
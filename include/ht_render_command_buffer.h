@@ -0,0 +1,100 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#pragma once
+
+#include <ht_platform.h>
+#include <ht_renderer.h>
+
+#include <vector>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        enum class RenderCommandType : uint8_t
+        {
+            SET_CLEAR_COLOR,
+            CLEAR,
+            RESIZE,
+            PRESENT
+        };
+
+        struct HT_API ClearColorCommand
+        {
+            float r;
+            float g;
+            float b;
+            float a;
+        };
+
+        struct HT_API ResizeCommand
+        {
+            uint32_t width;
+            uint32_t height;
+        };
+
+        /*Plain-data renderer call, replayed against an IRenderer on submit*/
+        struct HT_API RenderCommand
+        {
+            RenderCommandType type;
+            union
+            {
+                ClearColorCommand   color;
+                Graphics::ClearArgs clear;
+                ResizeCommand       resize;
+            };
+        };
+
+        /*
+        * Linear list of recorded renderer calls. A buffer is owned by one
+        * thread while recording, so several can be filled in parallel and
+        * handed to Renderer::Submit together; the order key decides which
+        * buffer's commands run first.
+        */
+        class HT_API RenderCommandBuffer
+        {
+        public:
+            RenderCommandBuffer();
+
+            void     Reserve(uint32_t capacity);
+
+            void     Reset();
+
+            void     SetOrder(uint32_t order);
+
+            uint32_t Order() const;
+
+            void     SetClearColor(const Graphics::Color& color);
+
+            void     Clear(Graphics::ClearArgs args);
+
+            void     ResizeBuffers(uint32_t width, uint32_t height);
+
+            void     Present();
+
+            void     Record(const RenderCommand& command);
+
+            uint32_t Count() const;
+
+            const RenderCommand* Commands() const;
+
+        private:
+            std::vector<RenderCommand> m_commands;
+            uint32_t                   m_order;
+        };
+
+    }
+
+}
@@ -0,0 +1,36 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#pragma once
+
+#include <ht_platform.h>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        /*
+        * Snapshot of simulation state the renderer needs for one frame,
+        * produced at the end of the update phase.
+        */
+        struct HT_API RenderView
+        {
+            uint64_t frameIndex;
+            float    interpolationAlpha;
+            float    clearColor[4];
+        };
+
+    }
+
+}
@@ -17,16 +17,50 @@
 #include <ht_platform.h>
 #include <ht_singleton.h>
 #include <ht_renderer.h>
+#include <ht_render_command_buffer.h>
+#include <ht_render_view.h>
+#include <ht_triple_buffer.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 namespace Hatchit {
 
     namespace Game {
 
+        struct HT_API RenderThreadParams
+        {
+            uint32_t framesInFlight;
+
+            /*Called on the render thread: true when it starts, false before it exits*/
+            void (*bindContext)(bool current);
+
+            /*Called on the render thread after each frame's commands have run*/
+            void (*swapBuffers)();
+        };
+
+        /*
+        * Frames are recorded into the buffer returned by BeginFrame and
+        * handed over with EndFrame. Without a render thread EndFrame runs
+        * the commands immediately; with one, up to framesInFlight recorded
+        * frames queue up and BeginFrame only blocks once all slots are busy.
+        * While the thread runs, the immediate calls (ClearBuffer, Present...)
+        * must not be used from other threads.
+        *
+        * Simulation state reaches the render side through a triple-buffered
+        * RenderView: the update phase fills BeginView and publishes it, and
+        * each frame is rendered with the newest view published so far.
+        */
         class HT_API Renderer : public Core::Singleton<Renderer>
         {
         public:
+            static const uint32_t MAX_FRAMES_IN_FLIGHT = 4;
+
+            Renderer();
 
-            static bool Initialize(const Graphics::RendererParams& params);
+            static bool Initialize(const Graphics::RendererParams& params, bool headless);
 
             static void DeInitialize();
 
@@ -38,8 +72,48 @@ namespace Hatchit {
 
             static void ResizeBuffers(uint32_t width, uint32_t height);
 
+            static void Submit(const RenderCommandBuffer& buffer);
+
+            static void Submit(const RenderCommandBuffer* const* buffers, uint32_t count);
+
+            static Graphics::IRenderer* Backend();
+
+            static bool StartThread(const RenderThreadParams& params);
+
+            static void StopThread();
+
+            static bool IsThreaded();
+
+            static RenderCommandBuffer& BeginFrame();
+
+            static void EndFrame();
+
+            static RenderView& BeginView();
+
+            static void PublishView();
+
         private:
-            Graphics::IRenderer* m_renderer;
+            static void Execute(const RenderCommand& command);
+
+            static void ApplyLatestView();
+
+            static void ThreadMain();
+
+            Graphics::IRenderer*    m_renderer;
+            RenderCommandBuffer     m_frames[MAX_FRAMES_IN_FLIGHT];
+            bool                    m_queued[MAX_FRAMES_IN_FLIGHT];
+            uint32_t                m_framesInFlight;
+            uint32_t                m_writeIndex;
+            uint32_t                m_readIndex;
+            RenderThreadParams      m_threadParams;
+            std::thread             m_thread;
+            std::mutex              m_frameMutex;
+            std::condition_variable m_frameQueued;
+            std::condition_variable m_frameRetired;
+            bool                    m_threaded;
+            bool                    m_stopping;
+            TripleBuffer<RenderView> m_views;
+            float                   m_clearColor[4];
         };
 
     }
@@ -0,0 +1,131 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+
+#pragma once
+
+#include <ht_platform.h>
+#include <ht_singleton.h>
+#include <ht_event.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        enum class ReplayMode
+        {
+            OFF,
+            RECORD,
+            PLAY
+        };
+
+        /*
+        * Records what a run took from the outside world each frame (the
+        * Time::Tick delta, the events the window published and whether it
+        * was visible and focused) and plays it back in place of the window
+        * and the clock. Played back with the same settings, the simulation
+        * sees an identical sequence of steps and input, so before/after
+        * runs of a change can be compared on the same workload.
+        *
+        * The log is a header followed by LZ4 blocks of a byte stream: per
+        * frame a varint delta, a varint event count, the events (type,
+        * timestamp and the payload for that type) and a flags byte. Frames
+        * may span blocks. Recording buffers a block at a time so steady
+        * frames don't allocate; playback decompresses the whole log up front.
+        */
+        class HT_API Replay : public Core::Singleton<Replay>
+        {
+        public:
+            static const uint32_t MAGIC = 0x50525448;    /*"HTRP"*/
+            static const uint32_t VERSION = 1;
+            static const uint32_t BLOCK_SIZE = 64 * 1024;
+
+            Replay();
+
+            static bool     Initialize(ReplayMode mode, const std::string& path);
+
+            /*Writes out the last partial block when recording*/
+            static void     DeInitialize();
+
+            static ReplayMode Mode();
+
+            static bool     IsPlaying();
+
+            /*
+            * Replaces Time::Tick(). Returns false once a replay has no frames
+            * left, which ends the run.
+            */
+            static bool     Tick();
+
+            /*
+            * Call between polling the window and EventBus::Dispatch. Records
+            * the events the window published this frame, or publishes the
+            * recorded ones (the window is not polled during playback).
+            */
+            static void     Events();
+
+            /*Records the live window state, or replaces it with the recorded one*/
+            static void     WindowState(bool& visible, bool& focused);
+
+            static uint64_t Frames();
+
+        private:
+            static const uint8_t VISIBLE = 1;
+            static const uint8_t FOCUSED = 2;
+
+            struct Header
+            {
+                uint32_t magic;
+                uint32_t version;
+            };
+
+            struct BlockHeader
+            {
+                uint32_t size;
+                uint32_t storedSize;
+            };
+
+            static size_t   PayloadSize(EventType type);
+
+            static void     Write(const void* data, size_t size);
+
+            static void     WriteVarint(uint64_t value);
+
+            static bool     Flush();
+
+            static bool     Read(void* data, size_t size);
+
+            static bool     ReadVarint(uint64_t& value);
+
+            static bool     Load(FILE* file);
+
+            ReplayMode              m_mode;
+            std::string             m_path;
+            FILE*                   m_file;
+            std::vector<uint8_t>    m_block;
+            std::vector<uint8_t>    m_compressed;
+            size_t                  m_blockSize;
+            std::vector<uint8_t>    m_stream;
+            size_t                  m_cursor;
+            bool                    m_exhausted;
+            uint64_t                m_frames;
+        };
+
+    }
+
+}
@@ -0,0 +1,152 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+
+#pragma once
+
+#include <ht_platform.h>
+#include <ht_singleton.h>
+#include <ht_asset_streamer.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        /*
+        * Slot in the cache plus the generation it was filled with, so
+        * handles to evicted resources stop matching.
+        */
+        struct HT_API ResourceHandle
+        {
+            uint32_t index;
+            uint32_t generation;
+
+            bool operator==(const ResourceHandle& other) const { return index == other.index && generation == other.generation; }
+            bool operator!=(const ResourceHandle& other) const { return !(*this == other); }
+        };
+
+        static const ResourceHandle NULL_RESOURCE = { 0xFFFFFFFF, 0 };
+
+        enum class ResourceState
+        {
+            INVALID,
+            LOADING,
+            READY,
+            FAILED
+        };
+
+        struct HT_API ResourceStats
+        {
+            uint64_t    hits;
+            uint64_t    misses;
+            uint64_t    evictions;
+            uint64_t    failures;
+            size_t      residentBytes;
+            size_t      peakBytes;
+            size_t      budgetBytes;
+            uint32_t    resident;
+            uint32_t    referenced;
+        };
+
+        /*
+        * Shared, reference-counted assets keyed by pack id. Acquire returns
+        * the cached entry (a hit, even while it is still loading) or starts
+        * one load through the AssetStreamer (a miss). Entries whose count
+        * drops to zero stay cached and are evicted least recently released
+        * first once resident bytes exceed the budget. Referenced entries are
+        * never evicted, so the budget can be overrun while they are held.
+        *
+        * The budget covers every cached payload byte, whether decompressed
+        * onto the heap or read in place from a mapped pack. Main thread only.
+        */
+        class HT_API ResourceCache : public Core::Singleton<ResourceCache>
+        {
+        public:
+            ResourceCache();
+
+            static bool     Initialize(size_t budgetBytes);
+
+            static void     DeInitialize();
+
+            /*Takes a reference; pair every Acquire and AddRef with a Release*/
+            static ResourceHandle Acquire(const std::string& name);
+
+            static ResourceHandle Acquire(uint64_t id);
+
+            static void     AddRef(ResourceHandle handle);
+
+            static void     Release(ResourceHandle handle);
+
+            static bool     IsValid(ResourceHandle handle);
+
+            static ResourceState State(ResourceHandle handle);
+
+            /*Null until the resource is READY*/
+            static const uint8_t* Data(ResourceHandle handle, size_t& size);
+
+            /*Retries loads the streamer had no room for and trims to the budget; once per frame*/
+            static void     Update();
+
+            static void     SetBudget(size_t budgetBytes);
+
+            static const ResourceStats& Stats();
+
+        private:
+            static const uint32_t NONE = 0xFFFFFFFF;
+
+            struct Slot
+            {
+                uint64_t                id;
+                uint32_t                generation;
+                uint32_t                refCount;
+                ResourceState           state;
+                const uint8_t*          data;
+                size_t                  size;
+                std::vector<uint8_t>    buffer;
+                uint32_t                prev;
+                uint32_t                next;
+            };
+
+            static Slot*    Lookup(ResourceHandle handle);
+
+            static bool     Request(uint32_t index);
+
+            static void     OnLoaded(StreamedAsset& asset, void* userData);
+
+            static void     Unreferenced(uint32_t index);
+
+            static void     LinkLRU(uint32_t index);
+
+            static void     UnlinkLRU(uint32_t index);
+
+            static void     Evict(uint32_t index);
+
+            static void     Trim();
+
+            std::vector<Slot>                       m_slots;
+            std::vector<uint32_t>                   m_freeSlots;
+            std::unordered_map<uint64_t, uint32_t>  m_lookup;
+            std::vector<uint32_t>                   m_deferred;
+            uint32_t                                m_lruHead;
+            uint32_t                                m_lruTail;
+            ResourceStats                           m_stats;
+        };
+
+    }
+
+}
@@ -17,6 +17,7 @@
 #include <ht_platform.h>
 #include <ht_window.h>
 #include <ht_sdl.h>
+#include <ht_event.h>
 
 
 namespace Hatchit {
@@ -25,7 +26,7 @@ namespace Hatchit {
 
         
 
-        class HT_API SDLWindow : public IWindow
+        class HT_API SDLWindow final : public IWindow
         {
         public:
             SDLWindow(const WindowParams& params);
@@ -40,17 +41,37 @@ namespace Hatchit {
 
             void    VPollEvents()       override;
 
+            bool    VWaitEvents(uint32_t timeoutMs) override;
+
+            void    VWake()             override;
+
             void    VClose()            override;
 
             void    VSwapBuffers()      override;
 
+            void    VMakeContextCurrent(bool current) override;
+
+            bool    VIsVisible()        override;
+
+            bool    VHasFocus()         override;
+
+            void    VSetDisplayFPS(bool display) override;
+
         private:
+            void    TrackWindowState(const Event& event);
+
+            void    HandleEvent(const SDL_Event& sdlEvent);
+
             SDL_Window*         m_handle;
             SDL_GLContext       m_glcontext;
             WindowParams        m_params;
             void*               m_nativeHandle;
             bool                m_running;
-
+            bool                m_visible;
+            bool                m_focused;
+            Uint32              m_wakeEvent;
+            int                 m_displayedFPS;
+            char                m_titleBuffer[256];
         };
 
     }
@@ -0,0 +1,131 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+
+#pragma once
+
+#include <ht_platform.h>
+#include <ht_singleton.h>
+#include <ht_inireader.h>
+#include <ht_window.h>
+#include <ht_frame_pacer.h>
+#include <ht_broadphase.h>
+#include <ht_replay.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        /*
+        * Every engine setting, parsed and validated once. Snapshots are
+        * immutable after publication; a reload publishes a new one with a
+        * higher version.
+        */
+        struct HT_API SettingsSnapshot
+        {
+            uint32_t        version;
+
+            size_t          frameArenaBytes;
+
+            int             workerCount;
+
+            uint32_t        eventCapacity;
+
+            uint32_t        updateRate;
+            uint32_t        maxUpdateSteps;
+            float           targetFPS;
+            uint32_t        spinMicroseconds;
+            PacingMode      pacing;
+            float           backgroundFPS;
+            bool            throttleUnfocused;
+            bool            eventDriven;
+            uint32_t        eventTimeoutMs;
+            uint32_t        allocationWarmupFrames;
+            bool            assertNoFrameAllocations;
+            bool            frameStats;
+
+            WindowParams    window;
+
+            float           clearColor[4];
+            bool            threaded;
+            uint32_t        framesInFlight;
+            uint32_t        resizeDebounceMs;
+
+            BroadphaseParams broadphase;
+
+            std::vector<std::string> packs;
+            uint32_t        streamingThreads;
+            uint32_t        streamingCapacity;
+            uint32_t        streamingBudgetUs;
+
+            size_t          resourceBudgetBytes;
+
+            std::string     startupReport;
+            bool            printStartup;
+
+            ReplayMode      replayMode;
+            std::string     replayPath;
+
+            bool            hotReload;
+        };
+
+        /*
+        * Current() is a single atomic load, so it can be read every frame.
+        * With a settings path, a watcher thread rebuilds the snapshot when
+        * the file changes. A replaced snapshot stays valid until the second
+        * Collect() after it, which the frame loop calls once per frame, so
+        * don't hold a reference across frames.
+        */
+        class HT_API Settings : public Core::Singleton<Settings>
+        {
+        public:
+            Settings();
+
+            static bool Initialize(Core::INIReader* reader, const std::string& path);
+
+            static void DeInitialize();
+
+            static const SettingsSnapshot& Current();
+
+            /*Frees snapshots replaced before the previous one; call between frames*/
+            static void Collect();
+
+            static bool Reload();
+
+            static void Build(Core::INIReader* reader, SettingsSnapshot& snapshot);
+
+        private:
+            static void Publish(SettingsSnapshot* snapshot);
+
+            static void WatchMain();
+
+            std::atomic<const SettingsSnapshot*>    m_current;
+            std::vector<SettingsSnapshot*>          m_snapshots;
+            const SettingsSnapshot*                 m_collected;
+            std::mutex                              m_lock;
+            std::string                             m_path;
+            std::vector<std::string>                m_sections;
+            std::thread                             m_watcher;
+            std::atomic<bool>                       m_stopping;
+        };
+
+    }
+
+}
@@ -0,0 +1,85 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+
+#pragma once
+
+#include <ht_platform.h>
+
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        /*
+        * Wall-clock timings of startup phases, possibly from several threads.
+        * Phases are fixed-size slots named by string literals; the report is
+        * written once startup is done.
+        */
+        class HT_API StartupTrace
+        {
+        public:
+            static const uint32_t MAX_PHASES = 32;
+
+            StartupTrace();
+
+            void     Start();
+
+            uint32_t BeginPhase(const char* name);
+
+            void     EndPhase(uint32_t phase);
+
+            void     Finish();
+
+            uint64_t TotalTicks() const;
+
+            bool     Write(const std::string& path) const;
+
+            void     Dump() const;
+
+        private:
+            struct Phase
+            {
+                const char* name;
+                uint64_t    start;
+                uint64_t    end;
+                bool        mainThread;
+            };
+
+            Phase               m_phases[MAX_PHASES];
+            uint32_t            m_count;
+            uint64_t            m_start;
+            uint64_t            m_end;
+            std::thread::id     m_mainThread;
+            mutable std::mutex  m_lock;
+        };
+
+        class HT_API ScopedStartupPhase
+        {
+        public:
+            ScopedStartupPhase(StartupTrace& trace, const char* name);
+
+            ~ScopedStartupPhase();
+
+        private:
+            StartupTrace&   m_trace;
+            uint32_t        m_phase;
+        };
+
+    }
+
+}
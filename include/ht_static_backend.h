@@ -0,0 +1,164 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+
+#pragma once
+
+#include <ht_platform.h>
+#include <ht_window_singleton.h>
+#include <ht_renderer_singleton.h>
+#include <ht_render_command_buffer.h>
+
+#ifdef HT_STATIC_BACKEND
+#ifdef HT_STATIC_BACKEND_HEADLESS
+#include <ht_nullwindow.h>
+#include <ht_nullrenderer.h>
+#else
+#include <ht_sdlwindow.h>
+#if defined(HT_SYS_WINDOWS) && defined(HT_STATIC_BACKEND_DIRECTX)
+#include <ht_dxrenderer.h>
+#else
+#include <ht_glrenderer.h>
+#endif
+#endif
+#endif
+
+namespace Hatchit {
+
+    namespace Game {
+
+        /*
+        * Calls the frame loop makes every frame, bound to concrete backend
+        * types. Each call is qualified (TWindow::VPollEvents) so it compiles
+        * to a direct, inlinable call instead of instance() plus a vtable load.
+        * Window::Initialize and Renderer::Initialize bind the pointers.
+        */
+        template <typename TWindow, typename TRenderer>
+        class StaticBackend
+        {
+        public:
+            static void BindWindow(TWindow* window) { s_window = window; }
+
+            static void BindRenderer(TRenderer* renderer) { s_renderer = renderer; }
+
+            static bool IsRunning() { return s_window->TWindow::VIsRunning(); }
+
+            static void PollEvents() { s_window->TWindow::VPollEvents(); }
+
+            static void SwapBuffers() { s_window->TWindow::VSwapBuffers(); }
+
+            static bool IsVisible() { return s_window->TWindow::VIsVisible(); }
+
+            static bool HasFocus() { return s_window->TWindow::VHasFocus(); }
+
+            static void Execute(const RenderCommand& command)
+            {
+                switch (command.type)
+                {
+                case RenderCommandType::SET_CLEAR_COLOR:
+                    s_renderer->TRenderer::VSetClearColor(Graphics::Color(command.color.r, command.color.g, command.color.b, command.color.a));
+                    break;
+
+                case RenderCommandType::CLEAR:
+                    s_renderer->TRenderer::VClearBuffer(command.clear);
+                    break;
+
+                case RenderCommandType::RESIZE:
+                    s_renderer->TRenderer::VResizeBuffers(command.resize.width, command.resize.height);
+                    break;
+
+                case RenderCommandType::PRESENT:
+                    s_renderer->TRenderer::VPresent();
+                    break;
+                }
+            }
+
+        private:
+            static TWindow*     s_window;
+            static TRenderer*   s_renderer;
+        };
+
+        template <typename TWindow, typename TRenderer>
+        TWindow* StaticBackend<TWindow, TRenderer>::s_window = nullptr;
+
+        template <typename TWindow, typename TRenderer>
+        TRenderer* StaticBackend<TWindow, TRenderer>::s_renderer = nullptr;
+
+        /*Same calls through the runtime-selected singletons and their interfaces*/
+        class DynamicBackend
+        {
+        public:
+            static bool IsRunning() { return Window::IsRunning(); }
+
+            static void PollEvents() { Window::PollEvents(); }
+
+            static void SwapBuffers() { Window::SwapBuffers(); }
+
+            static bool IsVisible() { return Window::IsVisible(); }
+
+            static bool HasFocus() { return Window::HasFocus(); }
+
+            static void Execute(const RenderCommand& command)
+            {
+                Graphics::IRenderer* renderer = Renderer::Backend();
+
+                switch (command.type)
+                {
+                case RenderCommandType::SET_CLEAR_COLOR:
+                    renderer->VSetClearColor(Graphics::Color(command.color.r, command.color.g, command.color.b, command.color.a));
+                    break;
+
+                case RenderCommandType::CLEAR:
+                    renderer->VClearBuffer(command.clear);
+                    break;
+
+                case RenderCommandType::RESIZE:
+                    renderer->VResizeBuffers(command.resize.width, command.resize.height);
+                    break;
+
+                case RenderCommandType::PRESENT:
+                    renderer->VPresent();
+                    break;
+                }
+            }
+        };
+
+        /*
+        * Build with HT_STATIC_BACKEND to fix the backends at compile time:
+        * NullWindow/NullRenderer with HT_STATIC_BACKEND_HEADLESS, otherwise
+        * SDLWindow with GLRenderer (DXRenderer with HT_STATIC_BACKEND_DIRECTX
+        * on Windows). [WINDOW] sBackend is then ignored.
+        */
+#ifdef HT_STATIC_BACKEND
+#ifdef HT_STATIC_BACKEND_HEADLESS
+        typedef NullWindow              StaticWindowType;
+        typedef NullRenderer            StaticRendererType;
+        static const bool               STATIC_BACKEND_HEADLESS = true;
+#else
+        typedef SDLWindow               StaticWindowType;
+        static const bool               STATIC_BACKEND_HEADLESS = false;
+#if defined(HT_SYS_WINDOWS) && defined(HT_STATIC_BACKEND_DIRECTX)
+        typedef Graphics::DXRenderer    StaticRendererType;
+#else
+        typedef Graphics::GLRenderer    StaticRendererType;
+#endif
+#endif
+        typedef StaticBackend<StaticWindowType, StaticRendererType> FrameBackend;
+#else
+        typedef DynamicBackend FrameBackend;
+#endif
+
+    }
+
+}
@@ -16,7 +16,8 @@
 
 #include <ht_platform.h>
 #include <ht_singleton.h>
-#include <ht_timer.h>
+#include <ht_frame_profiler.h>
+#include <ht_frame_pacer.h>
 
 namespace Hatchit {
 
@@ -25,12 +26,17 @@ namespace Hatchit {
         class HT_API Time : public Core::Singleton<Time>
         {
         public:
+            static const uint64_t TICKS_PER_SECOND = 1000000000ULL;
+
             Time();
 
             static void Start();
 
             static void Tick();
 
+            /*Advances game time by a given delta instead of the clock, for replays*/
+            static void Tick(uint64_t deltaTicks);
+
             static void CalculateFPS();
 
             static float DeltaTime();
@@ -43,12 +49,68 @@ namespace Hatchit {
 
             static float PausedTime();
 
+            static uint64_t Ticks();
+
+            static uint64_t DeltaTicks();
+
+            static uint64_t TotalTicks();
+
+            static uint64_t FrameIndex();
+
+            static double   TicksToSeconds(uint64_t ticks);
+
+            static uint64_t SecondsToTicks(double seconds);
+
+            static void  SetFixedTimeStep(float step, uint32_t maxStepsPerFrame);
+
+            static bool  ConsumeFixedStep();
+
+            static float FixedDeltaTime();
+
+            static float InterpolationAlpha();
+
+            static void  RecordPhase(FramePhase phase, uint64_t nanoseconds);
+
+            static float FrameTimePercentile(float percentile);
+
+            static float PhaseTimePercentile(FramePhase phase, float percentile);
+
+            static float MaxFrameTime();
+
+            static void  DumpFrameStats();
+
+            static void  SetFramePacing(float targetFPS, uint32_t spinMicroseconds, PacingMode mode);
+
+            static void  WaitForNextFrame();
+
+            static void  RecordPresent();
+
+            static float PresentInterval();
+
+            static uint64_t PacingErrorCount(uint32_t bucket);
+
+            static float PacingErrorBucketLimit(uint32_t bucket);
+
+            static float MaxPacingError();
+
         private:
-            Core::Timer* m_timer;
+            uint64_t     m_startTick;
+            uint64_t     m_currentTick;
+            uint64_t     m_deltaTicks;
+            uint64_t     m_frameIndex;
+            uint64_t     m_fpsWindowStart;
+            uint32_t     m_fpsFrameCount;
             float        m_fps;
             float        m_mspf;
+            uint64_t     m_fixedStep;
+            uint64_t     m_accumulator;
+            float        m_alpha;
+            uint32_t     m_maxSteps;
+            uint32_t     m_steps;
+            FrameProfiler m_profiler;
+            FramePacer   m_pacer;
         };
 
     }
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,146 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+
+#pragma once
+
+#include <ht_platform.h>
+
+#include <atomic>
+#include <vector>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        typedef uint32_t TransformId;
+
+        /*Row-major affine matrix: three rows of (rotation * scale | translation)*/
+        struct HT_API Matrix3x4
+        {
+            float m[12];
+        };
+
+        /*
+        * Scene graph transforms kept as flat arrays sorted by depth, so every
+        * node's parent sits in an earlier level and each level can be computed
+        * in SIMD batches (8 nodes with AVX, 4 with SSE) without dependencies.
+        * Local transforms are SoA; world matrices are AoS for consumers.
+        *
+        * Setters only mark a node dirty. Update recomputes dirty nodes and
+        * everything below them; clean subtrees are skipped batch by batch.
+        * Structural changes (Create, Destroy, SetParent) re-sort the arrays
+        * on the next Update, so batch them where possible.
+        */
+        class HT_API TransformHierarchy
+        {
+        public:
+            /*Implicit identity parent of every top-level node*/
+            static const TransformId ROOT = 0;
+            static const TransformId INVALID = 0xFFFFFFFF;
+
+            /*Levels at least this large are split across the job system*/
+            static const uint32_t PARALLEL_THRESHOLD = 8192;
+            static const uint32_t PARALLEL_BATCH = 2048;
+
+            TransformHierarchy();
+
+            void        Reserve(uint32_t count);
+
+            TransformId Create(TransformId parent = ROOT);
+
+            /*Destroys the node; its subtree goes with it on the next Update*/
+            void        Destroy(TransformId id);
+
+            /*Fails if it would make the node its own ancestor*/
+            bool        SetParent(TransformId id, TransformId parent);
+
+            TransformId Parent(TransformId id) const;
+
+            /*Setters ignore ids that aren't alive, including INVALID*/
+            void        SetPosition(TransformId id, float x, float y, float z);
+
+            void        SetRotation(TransformId id, float x, float y, float z, float w);
+
+            void        SetScale(TransformId id, float x, float y, float z);
+
+            /*Identity for ids that aren't alive*/
+            const Matrix3x4& World(TransformId id) const;
+
+            void        Update();
+
+            uint32_t    Count() const;
+
+            uint32_t    UpdatedCount() const;
+
+        private:
+            enum Channel
+            {
+                POSITION_X,
+                POSITION_Y,
+                POSITION_Z,
+                ROTATION_X,
+                ROTATION_Y,
+                ROTATION_Z,
+                ROTATION_W,
+                SCALE_X,
+                SCALE_Y,
+                SCALE_Z,
+                CHANNEL_COUNT
+            };
+
+            struct LevelJob
+            {
+                TransformHierarchy*     hierarchy;
+                uint32_t                begin;
+                uint32_t                end;
+                std::atomic<uint32_t>   updated;
+            };
+
+            bool        Alive(TransformId id) const;
+
+            void        Rebuild();
+
+            uint32_t    UpdateRange(uint32_t begin, uint32_t end);
+
+            static void UpdateLevelBatch(uint32_t begin, uint32_t end, void* data);
+
+            std::vector<float>          m_local[CHANNEL_COUNT];
+            std::vector<uint32_t>       m_parent;
+            std::vector<Matrix3x4>      m_world;
+            std::vector<uint8_t>        m_dirty;
+            std::vector<uint8_t>        m_destroyed;
+            std::vector<TransformId>    m_ids;
+
+            std::vector<uint32_t>       m_indexOf;
+            std::vector<TransformId>    m_freeIds;
+            std::vector<uint32_t>       m_levels;
+
+            /*Scratch for Rebuild, kept to avoid reallocating*/
+            std::vector<uint32_t>       m_depth;
+            std::vector<uint32_t>       m_order;
+            std::vector<uint32_t>       m_stack;
+            std::vector<float>          m_scratchFloats;
+            std::vector<uint32_t>       m_scratchIndices;
+            std::vector<Matrix3x4>      m_scratchWorld;
+            std::vector<uint8_t>        m_scratchBytes;
+
+            bool                        m_structureDirty;
+            bool                        m_anyDirty;
+            uint32_t                    m_updated;
+        };
+
+    }
+
+}
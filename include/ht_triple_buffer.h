@@ -0,0 +1,105 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#pragma once
+
+#include <ht_platform.h>
+
+#include <atomic>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        /*
+        * Lock-free single-writer/single-reader triple buffer. The writer
+        * fills WriteBuffer and Publishes it; the reader Acquires the most
+        * recently published value. Neither side ever waits or allocates, and
+        * the reader never sees a half-written value. Intermediate values are
+        * dropped if the writer publishes faster than the reader acquires.
+        */
+        template <typename T>
+        class TripleBuffer
+        {
+        public:
+            TripleBuffer();
+
+            T&       WriteBuffer();
+
+            void     Publish();
+
+            bool     Acquire();
+
+            const T& ReadBuffer() const;
+
+        private:
+            TripleBuffer(const TripleBuffer&);
+            TripleBuffer& operator=(const TripleBuffer&);
+
+            static const uint32_t INDEX_MASK = 0x3;
+            static const uint32_t FRESH_BIT = 0x4;
+
+            struct alignas(64) Slot
+            {
+                T value;
+            };
+
+            Slot                              m_slots[3];
+            alignas(64) std::atomic<uint32_t> m_middle;
+            alignas(64) uint32_t              m_write;
+            alignas(64) uint32_t              m_read;
+        };
+
+        template <typename T>
+        TripleBuffer<T>::TripleBuffer()
+        {
+            m_write = 0;
+            m_middle.store(1, std::memory_order_relaxed);
+            m_read = 2;
+        }
+
+        template <typename T>
+        T& TripleBuffer<T>::WriteBuffer()
+        {
+            return m_slots[m_write].value;
+        }
+
+        template <typename T>
+        void TripleBuffer<T>::Publish()
+        {
+            uint32_t previous = m_middle.exchange(m_write | FRESH_BIT, std::memory_order_acq_rel);
+            m_write = previous & INDEX_MASK;
+        }
+
+        template <typename T>
+        bool TripleBuffer<T>::Acquire()
+        {
+            if (!(m_middle.load(std::memory_order_relaxed) & FRESH_BIT))
+                return false;
+
+            uint32_t previous = m_middle.exchange(m_read, std::memory_order_acq_rel);
+            m_read = previous & INDEX_MASK;
+
+            return true;
+        }
+
+        template <typename T>
+        const T& TripleBuffer<T>::ReadBuffer() const
+        {
+            return m_slots[m_read].value;
+        }
+
+    }
+
+}
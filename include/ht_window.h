@@ -23,6 +23,12 @@ namespace Hatchit {
 
     namespace Game {
 
+        enum class WindowBackend
+        {
+            SDL,
+            HEADLESS
+        };
+
         struct HT_API WindowParams
         {
             std::string title;
@@ -31,6 +37,8 @@ namespace Hatchit {
             int width;
             int height;
             Graphics::RendererType renderer;
+            WindowBackend backend;
+            uint32_t frameCount;
             bool displayFPS;
             bool debugWindowEvents;
         };
@@ -44,8 +52,14 @@ namespace Hatchit {
             virtual void*   VNativeHandle() = 0;
             virtual bool    VIsRunning() = 0;
             virtual void    VPollEvents() = 0;
+            virtual bool    VWaitEvents(uint32_t timeoutMs) = 0;
+            virtual void    VWake() = 0;
             virtual void    VClose() = 0;
             virtual void    VSwapBuffers() = 0;
+            virtual void    VMakeContextCurrent(bool current) = 0;
+            virtual bool    VIsVisible() = 0;
+            virtual bool    VHasFocus() = 0;
+            virtual void    VSetDisplayFPS(bool display) = 0;
         };
 
 
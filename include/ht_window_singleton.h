@@ -18,6 +18,8 @@
 #include <ht_window.h>
 #include <ht_singleton.h>
 
+#include <atomic>
+
 namespace Hatchit {
 
     namespace Game {
@@ -31,16 +33,31 @@ namespace Hatchit {
 
             static void  PollEvents();
 
+            static bool  WaitEvents(uint32_t timeoutMs);
+
+            static void  RequestRedraw();
+
+            static bool  ConsumeRedraw();
+
             static void  Close();
 
             static bool  IsRunning();
 
             static void  SwapBuffers();
+
+            static void  MakeContextCurrent(bool current);
+
+            static bool  IsVisible();
+
+            static bool  HasFocus();
+
+            static void  SetDisplayFPS(bool display);
             
             static void* NativeHandle();
 
         private:
-            IWindow* m_window;
+            IWindow*            m_window;
+            std::atomic<bool>   m_redrawRequested;
         };
 
     }
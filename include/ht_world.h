@@ -0,0 +1,304 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+
+#pragma once
+
+#include <ht_platform.h>
+#include <ht_entity.h>
+#include <ht_archetype.h>
+#include <ht_entity_command_buffer.h>
+#include <ht_jobsystem.h>
+
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        /*
+        * Archetype-based entity store. Queries name their component types
+        * and visit every archetype that has all of them, chunk by chunk:
+        *
+        *   world.Each<Position, Velocity>([](Entity e, Position& p, Velocity& v) { ... });
+        *
+        * Structural changes (create, destroy, add, remove) move rows between
+        * archetypes and must not happen during a query; record them in
+        * Commands() instead. FlushCommands applies each thread's buffer.
+        */
+        class HT_API World
+        {
+        public:
+            World();
+
+            ~World();
+
+            bool     Initialize(uint32_t threadCount);
+
+            void     DeInitialize();
+
+            void     SetThreadCount(uint32_t threadCount);
+
+            Entity   Create();
+
+            template <typename... T>
+            Entity   Create(const T&... components);
+
+            void     Destroy(Entity entity);
+
+            bool     IsAlive(Entity entity) const;
+
+            uint32_t EntityCount() const;
+
+            uint32_t ArchetypeCount() const;
+
+            template <typename T>
+            void     Add(Entity entity, const T& component);
+
+            template <typename T>
+            void     Remove(Entity entity);
+
+            template <typename T>
+            T*       Get(Entity entity);
+
+            template <typename T>
+            bool     Has(Entity entity) const;
+
+            void     AddRaw(Entity entity, ComponentId id, const void* data);
+
+            void     RemoveRaw(Entity entity, ComponentId id);
+
+            /*fn(Entity, T&...) for every matching entity*/
+            template <typename... T, typename F>
+            void     Each(F fn);
+
+            /*fn(uint32_t count, const Entity*, T*...) once per matching chunk, for loops over whole columns*/
+            template <typename... T, typename F>
+            void     EachChunk(F fn);
+
+            /*Each, with chunks spread over the job system; fn runs concurrently*/
+            template <typename... T, typename F>
+            void     ParallelEach(F fn);
+
+            /*The calling thread's command buffer*/
+            EntityCommandBuffer& Commands();
+
+            void     FlushCommands();
+
+            void     Playback(EntityCommandBuffer& buffer);
+
+        private:
+            struct EntityRecord
+            {
+                Archetype*  archetype;
+                uint32_t    chunk;
+                uint32_t    row;
+                uint32_t    generation;
+            };
+
+            struct ChunkRef
+            {
+                Archetype*  archetype;
+                uint32_t    chunk;
+            };
+
+            template <typename F>
+            struct ParallelContext
+            {
+                World*              world;
+                F*                  fn;
+                const ComponentId*  ids;
+            };
+
+            Archetype* FindArchetype(ComponentMask mask);
+
+            Archetype* AddTransition(Archetype* archetype, ComponentId id);
+
+            Archetype* RemoveTransition(Archetype* archetype, ComponentId id);
+
+            Entity     Place(Archetype* archetype);
+
+            void       Move(Entity entity, Archetype* target);
+
+            void       Detach(EntityRecord& record);
+
+            void       GatherChunks(ComponentMask mask);
+
+            template <typename... T, typename F, uint32_t... I>
+            static void EachRow(F& fn, uint32_t count, const Entity* entities, void* const* columns, IndexSequence<I...>);
+
+            template <typename... T, typename F, uint32_t... I>
+            static void CallChunk(F& fn, uint32_t count, const Entity* entities, void* const* columns, IndexSequence<I...>);
+
+            template <typename F, typename... T>
+            static void ParallelBatch(uint32_t begin, uint32_t end, void* data);
+
+            std::vector<EntityRecord>                       m_records;
+            std::vector<uint32_t>                           m_freeIndices;
+            std::vector<Archetype*>                         m_archetypes;
+            std::unordered_map<ComponentMask, Archetype*>   m_archetypeLookup;
+            Archetype*                                      m_emptyArchetype;
+            std::vector<EntityCommandBuffer>                m_commands;
+            std::vector<Entity>                             m_placeholders;
+            std::vector<ChunkRef>                           m_chunkRefs;
+            uint32_t                                        m_entityCount;
+        };
+
+        template <typename... T>
+        Entity World::Create(const T&... components)
+        {
+            static const ComponentId ids[] = { 0, ComponentRegistry::Id<T>()... };
+            const void* data[] = { nullptr, &components... };
+
+            Entity entity = Place(FindArchetype(MaskOf<T...>()));
+            const EntityRecord& record = m_records[entity.index];
+            for (uint32_t i = 1; i < sizeof...(T) + 1; i++)
+                std::memcpy(record.archetype->Component(record.chunk, record.row, ids[i]), data[i], ComponentRegistry::Info(ids[i]).size);
+
+            return entity;
+        }
+
+        template <typename T>
+        void World::Add(Entity entity, const T& component)
+        {
+            AddRaw(entity, ComponentRegistry::Id<T>(), &component);
+        }
+
+        template <typename T>
+        void World::Remove(Entity entity)
+        {
+            RemoveRaw(entity, ComponentRegistry::Id<T>());
+        }
+
+        template <typename T>
+        T* World::Get(Entity entity)
+        {
+            ComponentId id = ComponentRegistry::Id<T>();
+            if (!IsAlive(entity))
+                return nullptr;
+
+            const EntityRecord& record = m_records[entity.index];
+            if (!record.archetype->Has(id))
+                return nullptr;
+
+            return static_cast<T*>(record.archetype->Component(record.chunk, record.row, id));
+        }
+
+        template <typename T>
+        bool World::Has(Entity entity) const
+        {
+            return IsAlive(entity) && m_records[entity.index].archetype->Has(ComponentRegistry::Id<T>());
+        }
+
+        template <typename... T, typename F, uint32_t... I>
+        void World::EachRow(F& fn, uint32_t count, const Entity* entities, void* const* columns, IndexSequence<I...>)
+        {
+            for (uint32_t row = 0; row < count; row++)
+                fn(entities[row], static_cast<T*>(columns[I])[row]...);
+        }
+
+        template <typename... T, typename F, uint32_t... I>
+        void World::CallChunk(F& fn, uint32_t count, const Entity* entities, void* const* columns, IndexSequence<I...>)
+        {
+            fn(count, entities, static_cast<T*>(columns[I])...);
+        }
+
+        template <typename... T, typename F>
+        void World::Each(F fn)
+        {
+            static const ComponentId ids[] = { ComponentRegistry::Id<T>()... };
+            ComponentMask mask = MaskOf<T...>();
+
+            for (size_t a = 0; a < m_archetypes.size(); a++)
+            {
+                Archetype* archetype = m_archetypes[a];
+                if ((archetype->Mask() & mask) != mask)
+                    continue;
+
+                for (uint32_t c = 0; c < archetype->ChunkCount(); c++)
+                {
+                    const Archetype::Chunk& chunk = archetype->GetChunk(c);
+
+                    void* columns[sizeof...(T)];
+                    for (uint32_t i = 0; i < sizeof...(T); i++)
+                        columns[i] = archetype->Column(chunk, ids[i]);
+
+                    EachRow<T...>(fn, chunk.count, archetype->Entities(chunk), columns, typename MakeIndexSequence<sizeof...(T)>::Type());
+                }
+            }
+        }
+
+        template <typename... T, typename F>
+        void World::EachChunk(F fn)
+        {
+            static const ComponentId ids[] = { ComponentRegistry::Id<T>()... };
+            ComponentMask mask = MaskOf<T...>();
+
+            for (size_t a = 0; a < m_archetypes.size(); a++)
+            {
+                Archetype* archetype = m_archetypes[a];
+                if ((archetype->Mask() & mask) != mask)
+                    continue;
+
+                for (uint32_t c = 0; c < archetype->ChunkCount(); c++)
+                {
+                    const Archetype::Chunk& chunk = archetype->GetChunk(c);
+
+                    void* columns[sizeof...(T)];
+                    for (uint32_t i = 0; i < sizeof...(T); i++)
+                        columns[i] = archetype->Column(chunk, ids[i]);
+
+                    CallChunk<T...>(fn, chunk.count, archetype->Entities(chunk), columns, typename MakeIndexSequence<sizeof...(T)>::Type());
+                }
+            }
+        }
+
+        template <typename F, typename... T>
+        void World::ParallelBatch(uint32_t begin, uint32_t end, void* data)
+        {
+            ParallelContext<F>* context = static_cast<ParallelContext<F>*>(data);
+
+            for (uint32_t i = begin; i < end; i++)
+            {
+                const ChunkRef& ref = context->world->m_chunkRefs[i];
+                const Archetype::Chunk& chunk = ref.archetype->GetChunk(ref.chunk);
+
+                void* columns[sizeof...(T)];
+                for (uint32_t c = 0; c < sizeof...(T); c++)
+                    columns[c] = ref.archetype->Column(chunk, context->ids[c]);
+
+                EachRow<T...>(*context->fn, chunk.count, ref.archetype->Entities(chunk), columns, typename MakeIndexSequence<sizeof...(T)>::Type());
+            }
+        }
+
+        template <typename... T, typename F>
+        void World::ParallelEach(F fn)
+        {
+            static const ComponentId ids[] = { ComponentRegistry::Id<T>()... };
+
+            /*A chunk is the unit of work: rows of one chunk never split across threads*/
+            GatherChunks(MaskOf<T...>());
+
+            ParallelContext<F> context;
+            context.world = this;
+            context.fn = &fn;
+            context.ids = ids;
+            JobSystem::ParallelFor(static_cast<uint32_t>(m_chunkRefs.size()), 1, &World::ParallelBatch<F, T...>, &context);
+        }
+
+    }
+
+}
@@ -0,0 +1,245 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_allocation_tracker.h>
+#include <ht_debug.h>
+#include <ht_time_singleton.h>
+
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <new>
+
+#ifdef HT_SYS_WINDOWS
+#include <malloc.h>
+#endif
+
+namespace Hatchit {
+
+    namespace Game {
+
+        static thread_local uint64_t s_allocations = 0;
+        static thread_local uint64_t s_allocatedBytes = 0;
+
+        /*Every thread's allocations, so work a frame hands to jobs or other threads is seen too*/
+        static std::atomic<uint64_t> s_totalAllocations(0);
+        static std::atomic<uint64_t> s_totalAllocatedBytes(0);
+
+#ifdef HT_TRACK_ALLOCATIONS
+        static void CountAllocation(std::size_t size)
+        {
+            s_allocations++;
+            s_allocatedBytes += size;
+            s_totalAllocations.fetch_add(1, std::memory_order_relaxed);
+            s_totalAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+        }
+#endif
+
+        uint64_t AllocationTracker::ThreadAllocations()
+        {
+            return s_allocations;
+        }
+
+        uint64_t AllocationTracker::ThreadAllocatedBytes()
+        {
+            return s_allocatedBytes;
+        }
+
+        uint64_t AllocationTracker::TotalAllocations()
+        {
+            return s_totalAllocations.load(std::memory_order_relaxed);
+        }
+
+        uint64_t AllocationTracker::TotalAllocatedBytes()
+        {
+            return s_totalAllocatedBytes.load(std::memory_order_relaxed);
+        }
+
+        bool AllocationTracker::Enabled()
+        {
+#ifdef HT_TRACK_ALLOCATIONS
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        FrameAllocationGuard::FrameAllocationGuard(bool armed, bool assertOnAllocation)
+        {
+            m_allocations = AllocationTracker::TotalAllocations();
+            m_bytes = AllocationTracker::TotalAllocatedBytes();
+            m_threadAllocations = s_allocations;
+            m_armed = armed && AllocationTracker::Enabled();
+            m_assert = assertOnAllocation;
+        }
+
+        FrameAllocationGuard::~FrameAllocationGuard()
+        {
+            uint64_t allocations = AllocationTracker::TotalAllocations() - m_allocations;
+            if (!m_armed || allocations == 0)
+                return;
+
+            Core::DebugPrintF("Frame %llu made %llu heap allocation(s) totalling %llu bytes (%llu on the frame thread)\n",
+                static_cast<unsigned long long>(Time::FrameIndex()),
+                static_cast<unsigned long long>(allocations),
+                static_cast<unsigned long long>(AllocationTracker::TotalAllocatedBytes() - m_bytes),
+                static_cast<unsigned long long>(s_allocations - m_threadAllocations));
+
+            if (m_assert)
+                assert(!"Heap allocation inside a steady-state frame");
+        }
+    }
+
+}
+
+#ifdef HT_TRACK_ALLOCATIONS
+
+static void* TrackedAllocate(std::size_t size)
+{
+    Hatchit::Game::CountAllocation(size);
+
+    void* p = std::malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+
+    return p;
+}
+
+void* operator new(std::size_t size)
+{
+    return TrackedAllocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return TrackedAllocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return TrackedAllocate(size); }
+    catch (...) { return nullptr; }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return TrackedAllocate(size); }
+    catch (...) { return nullptr; }
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+    std::free(p);
+}
+
+#ifdef __cpp_aligned_new
+
+/*Over-aligned types (alignas(64) queues, jobs) come through these in C++17 builds*/
+static void* TrackedAllocateAligned(std::size_t size, std::align_val_t alignment)
+{
+    Hatchit::Game::CountAllocation(size);
+
+    std::size_t bytes = size ? size : 1;
+#ifdef HT_SYS_WINDOWS
+    void* p = _aligned_malloc(bytes, static_cast<std::size_t>(alignment));
+#else
+    void* p = nullptr;
+    if (posix_memalign(&p, static_cast<std::size_t>(alignment), bytes) != 0)
+        p = nullptr;
+#endif
+    if (!p)
+        throw std::bad_alloc();
+
+    return p;
+}
+
+static void TrackedFreeAligned(void* p)
+{
+#ifdef HT_SYS_WINDOWS
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return TrackedAllocateAligned(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return TrackedAllocateAligned(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    try { return TrackedAllocateAligned(size, alignment); }
+    catch (...) { return nullptr; }
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    try { return TrackedAllocateAligned(size, alignment); }
+    catch (...) { return nullptr; }
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+    TrackedFreeAligned(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept
+{
+    TrackedFreeAligned(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept
+{
+    TrackedFreeAligned(p);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept
+{
+    TrackedFreeAligned(p);
+}
+
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    TrackedFreeAligned(p);
+}
+
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    TrackedFreeAligned(p);
+}
+
+#endif
+
+#endif
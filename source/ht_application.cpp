@@ -17,6 +17,19 @@
 #include <ht_window_singleton.h>
 #include <ht_renderer_singleton.h>
 #include <ht_time_singleton.h>
+#include <ht_allocation_tracker.h>
+#include <ht_jobsystem.h>
+#include <ht_eventbus_singleton.h>
+#include <ht_input_singleton.h>
+#include <ht_static_backend.h>
+#include <ht_settings_singleton.h>
+#include <ht_asset_streamer.h>
+#include <ht_resource_cache.h>
+#include <ht_replay.h>
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
 
 namespace Hatchit {
 
@@ -24,9 +37,42 @@ namespace Hatchit {
 
         using namespace Graphics;
 
-        Application::Application(Core::INIReader* settings)
+        static void SwapAndRecordPresent()
+        {
+            FrameBackend::SwapBuffers();
+            Time::RecordPresent();
+        }
+
+        Application::Application(Core::INIReader* settings, const std::string& settingsPath)
         {
             m_settings = settings;
+            m_settingsPath = settingsPath;
+            m_settingsVersion = 0;
+            m_workerCount = -1;
+            m_allocationWarmupFrames = 0;
+            m_assertNoFrameAllocations = false;
+            for (uint32_t i = 0; i < 4; i++)
+                m_clearColor[i] = 0.0f;
+            m_updateRate = 60;
+            m_maxUpdateSteps = 5;
+            m_targetFPS = 0.0f;
+            m_spinMicroseconds = 1000;
+            m_pacing = PacingMode::FIXED;
+            m_backgroundFPS = 10.0f;
+            m_throttleUnfocused = false;
+            m_background = false;
+            m_eventDriven = false;
+            m_eventTimeoutMs = 250;
+            m_eventArrived = false;
+            m_resizeSubscription = 0;
+            m_resizePending = false;
+            m_resizeWidth = 0;
+            m_resizeHeight = 0;
+            m_resizeTick = 0;
+            m_resizeDebounceTicks = 0;
+            m_streamingBudgetTicks = 0;
+            m_firstFramePhase = StartupTrace::MAX_PHASES;
+            m_printStartup = false;
         }
 
         int Application::Run()
@@ -38,19 +84,135 @@ namespace Hatchit {
             }
 
             Time::Start();
-            while (Window::IsRunning())
+            m_firstFramePhase = m_startupTrace.BeginPhase("first frame");
+            while (FrameBackend::IsRunning())
             {
-                Time::Tick();
+                /*Startup ends once the first frame is out; report outside the allocation guard*/
+                if (m_firstFramePhase != StartupTrace::MAX_PHASES && Time::FrameIndex() > 0)
+                    ReportStartup();
+
+                /*Pick up a hot-reloaded settings snapshot between frames and free retired ones*/
+                Settings::Collect();
+                const SettingsSnapshot& settings = Settings::Current();
+                if (settings.version != m_settingsVersion)
+                    ApplySettings(settings);
+
+                /*Steady-state frames must not touch the heap (checked in debug builds)*/
+                FrameAllocationGuard allocationGuard(Time::FrameIndex() >= m_allocationWarmupFrames, m_assertNoFrameAllocations);
+
+                m_frameArena.NextFrame();
+
+                {
+                    /*A replay supplies the frame's delta and ends the run when it runs out*/
+                    ScopedFramePhase phase(FramePhase::TICK);
+                    if (!Replay::Tick())
+                        break;
+                }
+
+                {
+                    ScopedFramePhase phase(FramePhase::EVENTS);
+                    if (!Replay::IsPlaying())
+                        FrameBackend::PollEvents();
+                    Replay::Events();
+                    EventBus::Dispatch();
+                    Input::Update();
 
-                Window::PollEvents();
+                    /*Loads finished by the streaming threads, bounded so a burst can't hitch the frame*/
+                    AssetStreamer::Dispatch(m_streamingBudgetTicks);
+                    ResourceCache::Update();
+                }
 
-                Renderer::ClearBuffer(ClearArgs::ColorDepthStencil);
+                /*Hidden or minimized (or unfocused, if configured): keep simulating, stop rendering*/
+                bool visible = FrameBackend::IsVisible();
+                bool focused = FrameBackend::HasFocus();
+                Replay::WindowState(visible, focused);
+                bool background = !visible || (m_throttleUnfocused && !focused);
+                if (background != m_background)
+                    SetBackground(background);
 
-                Renderer::Present();
+                {
+                    /*Run simulation at a fixed rate, independent of the render rate*/
+                    ScopedFramePhase phase(FramePhase::UPDATE);
+                    while (Time::ConsumeFixedStep())
+                    {
+                        Update();
+                        m_world.FlushCommands();
 
-                Window::SwapBuffers();
+                        /*Queries and pairs seen by the next step reflect this one's moves*/
+                        m_broadphase.Update();
+                    }
+                }
+
+                {
+                    /*Propagate changed local transforms once per frame, then hand the view over*/
+                    ScopedFramePhase phase(FramePhase::TRANSFORM);
+                    m_transforms.Update();
+
+                    PublishRenderView();
+                }
+
+                /*Event-driven mode only draws when something happened or asked for it*/
+                bool redraw = Window::ConsumeRedraw() || m_eventArrived || !m_eventDriven || ResizeDue();
+                m_eventArrived = false;
+
+                if (!m_background && redraw)
+                {
+                    {
+                        ScopedFramePhase phase(FramePhase::RECORD);
+                        RenderCommandBuffer& commands = Renderer::BeginFrame();
+                        ApplyPendingResize(commands);
+                        commands.Clear(ClearArgs::ColorDepthStencil);
+                        commands.Present();
+                    }
+
+                    {
+                        ScopedFramePhase phase(FramePhase::SUBMIT);
+                        Renderer::EndFrame();
+                    }
+
+                    {
+                        /*The render thread swaps on its own when threaded*/
+                        ScopedFramePhase phase(FramePhase::SWAP);
+                        if (!Renderer::IsThreaded())
+                            SwapAndRecordPresent();
+                    }
+                }
 
                 Time::CalculateFPS();
+
+                {
+                    /*Replays run as fast as they can*/
+                    ScopedFramePhase phase(FramePhase::PACE);
+                    if (!Replay::IsPlaying())
+                        Time::WaitForNextFrame();
+
+                    /*Sleep in the OS until input, a window event or Window::RequestRedraw*/
+                    if (m_eventDriven && FrameBackend::IsRunning())
+                        m_eventArrived = Window::WaitEvents(EventWaitTimeout());
+                }
+            }
+
+            if (m_firstFramePhase != StartupTrace::MAX_PHASES)
+                ReportStartup();
+
+            if (Settings::Current().frameStats)
+            {
+                Time::DumpFrameStats();
+                Core::DebugPrintF("Frame arena: high water %llu of %llu bytes, %llu failed allocation(s)\n",
+                    static_cast<unsigned long long>(m_frameArena.HighWaterMark()),
+                    static_cast<unsigned long long>(m_frameArena.Capacity()),
+                    static_cast<unsigned long long>(m_frameArena.FailedAllocations()));
+
+                const ResourceStats& resources = ResourceCache::Stats();
+                Core::DebugPrintF("Resources: %llu hit(s), %llu miss(es), %llu eviction(s), %llu failure(s); %u resident, %llu bytes (peak %llu) of %llu\n",
+                    static_cast<unsigned long long>(resources.hits),
+                    static_cast<unsigned long long>(resources.misses),
+                    static_cast<unsigned long long>(resources.evictions),
+                    static_cast<unsigned long long>(resources.failures),
+                    resources.resident,
+                    static_cast<unsigned long long>(resources.residentBytes),
+                    static_cast<unsigned long long>(resources.peakBytes),
+                    static_cast<unsigned long long>(resources.budgetBytes));
             }
 
             DeInitialize();
@@ -58,47 +220,355 @@ namespace Hatchit {
             return 0;
         }
 
+        FrameArena& Application::Arena()
+        {
+            return m_frameArena;
+        }
+
+        World& Application::Entities()
+        {
+            return m_world;
+        }
+
+        TransformHierarchy& Application::Transforms()
+        {
+            return m_transforms;
+        }
+
+        Broadphase& Application::Spatial()
+        {
+            return m_broadphase;
+        }
+
         bool Application::Initialize()
         {
-            /*Initialize Window with values from settings file*/
-            WindowParams wparams;
-            wparams.title = m_settings->GetValue("WINDOW", "sTitle", std::string("Hatchit Engine"));
-            wparams.x = m_settings->GetValue("WINDOW", "iX", -1);
-            wparams.y = m_settings->GetValue("WINDOW", "iY", -1);
-            wparams.width = m_settings->GetValue("WINDOW", "iWidth", 800);
-            wparams.height = m_settings->GetValue("WINDOW", "iHeight", 600);
-            wparams.displayFPS = m_settings->GetValue("WINDOW", "bFPS", false);
-            wparams.debugWindowEvents = m_settings->GetValue("WINDOW", "bDebugWindowEvents", false);
-
-            /*Initialize Renderer with values from settings file*/
-            RendererParams rparams;
-#ifdef HT_SYS_LINUX
-            rparams.renderer = RendererType::OPENGL;
+            m_startupTrace.Start();
+
+            {
+                ScopedStartupPhase phase(m_startupTrace, "settings");
+                if (!Settings::Initialize(m_settings, m_settingsPath))
+                    return false;
+            }
+
+            const SettingsSnapshot& settings = Settings::Current();
+            LoadSettings(settings);
+            m_updateRate = settings.updateRate;
+            m_maxUpdateSteps = settings.maxUpdateSteps;
+            m_eventDriven = settings.eventDriven;
+            m_eventArrived = false;
+            m_resizePending = false;
+            m_allocationWarmupFrames = settings.allocationWarmupFrames;
+            m_assertNoFrameAllocations = settings.assertNoFrameAllocations;
+            m_workerCount = settings.workerCount;
+
+            WindowParams wparams = settings.window;
+
+            /*Playback needs no display and must not block waiting for events*/
+            if (settings.replayMode == ReplayMode::PLAY)
+            {
+#if defined(HT_STATIC_BACKEND) && !defined(HT_STATIC_BACKEND_HEADLESS)
+                /*The backend is fixed to SDL, so playback would open a real window it never polls*/
+#ifdef _DEBUG
+                Core::DebugPrintF("Replay playback needs a headless build (HT_STATIC_BACKEND_HEADLESS) or the runtime backend. Exiting.\n");
+#endif
+                return false;
 #else
-            std::string renderer = m_settings->GetValue("RENDERER", "sRenderer", std::string("DIRECTX"));
-            rparams.renderer = (renderer == "DIRECTX") ? RendererType::DIRECTX : RendererType::OPENGL;
+                wparams.backend = WindowBackend::HEADLESS;
+                m_eventDriven = false;
 #endif
-            wparams.renderer = rparams.renderer;
+            }
 
-            if (!Window::Initialize(wparams))
-                return false;
+#ifdef HT_STATIC_BACKEND
+            /*[WINDOW] sBackend is ignored when the backends are fixed at compile time*/
+            wparams.backend = STATIC_BACKEND_HEADLESS ? WindowBackend::HEADLESS : WindowBackend::SDL;
+#endif
+
+            RendererParams rparams;
+            rparams.renderer = wparams.renderer;
+            rparams.clearColor = Color(m_clearColor[0], m_clearColor[1], m_clearColor[2], m_clearColor[3]);
 
+            RenderThreadParams tparams;
+            tparams.framesInFlight = settings.framesInFlight;
+            tparams.bindContext = &Window::MakeContextCurrent;
+            tparams.swapBuffers = &SwapAndRecordPresent;
 
-            rparams.window = Window::NativeHandle();
-            rparams.clearColor = Color( m_settings->GetValue("RENDERER", "fClearR", 0.0f),
-                                        m_settings->GetValue("RENDERER", "fClearG", 0.0f),
-                                        m_settings->GetValue("RENDERER", "fClearB", 0.0f),
-                                        m_settings->GetValue("RENDERER", "fClearA", 0.0f));
-            if (!Renderer::Initialize(rparams))
+            /*
+            * Memory and worker threads don't depend on the window, so they come
+            * up on a helper thread while the main thread creates the window and
+            * context, which SDL and GL require to stay on the main thread.
+            */
+            bool workerInitialized = false;
+            std::thread worker([&]()
+            {
+                {
+                    ScopedStartupPhase phase(m_startupTrace, "frame arena");
+                    if (!m_frameArena.Initialize(settings.frameArenaBytes))
+                        return;
+                }
+
+                {
+                    ScopedStartupPhase phase(m_startupTrace, "job system");
+                    if (!JobSystem::Initialize(settings.workerCount))
+                        return;
+                }
+
+                {
+                    /*A pack that fails to mount is reported and skipped; its loads will fail*/
+                    ScopedStartupPhase phase(m_startupTrace, "streaming");
+                    if (!AssetStreamer::Initialize(settings.streamingThreads, settings.streamingCapacity))
+                        return;
+                    for (size_t i = 0; i < settings.packs.size(); i++)
+                        AssetStreamer::Mount(settings.packs[i]);
+                    ResourceCache::Initialize(settings.resourceBudgetBytes);
+                }
+
+                {
+                    ScopedStartupPhase phase(m_startupTrace, "replay");
+                    if (!Replay::Initialize(settings.replayMode, settings.replayPath))
+                        return;
+                }
+
+                workerInitialized = true;
+            });
+
+            bool initialized = InitializeMainThread(wparams, rparams, settings.eventCapacity);
+
+            {
+                ScopedStartupPhase phase(m_startupTrace, "join");
+                worker.join();
+            }
+
+            if (!initialized || !workerInitialized)
                 return false;
 
+            /*One command buffer per job system thread*/
+            m_world.Initialize(JobSystem::ThreadCount());
+
+            m_broadphase.Configure(settings.broadphase);
+
+            SetBackground(false);
+
+            if (settings.threaded)
+            {
+                ScopedStartupPhase phase(m_startupTrace, "render thread");
+
+                /*The context can only be current on one thread at a time*/
+                Window::MakeContextCurrent(false);
+                if (!Renderer::StartThread(tparams))
+                    return false;
+            }
+
             return true;
         }
 
+        bool Application::InitializeMainThread(const WindowParams& wparams, RendererParams& rparams, uint32_t eventCapacity)
+        {
+            {
+                ScopedStartupPhase phase(m_startupTrace, "events");
+                if (!EventBus::Initialize(eventCapacity))
+                    return false;
+
+                if (!Input::Initialize())
+                    return false;
+
+                m_resizeSubscription = EventBus::Subscribe(EventType::WINDOW_RESIZED, &Application::OnWindowResized, this);
+            }
+
+            {
+                ScopedStartupPhase phase(m_startupTrace, "window");
+                if (!Window::Initialize(wparams))
+                    return false;
+            }
+
+            {
+                ScopedStartupPhase phase(m_startupTrace, "renderer");
+                rparams.window = Window::NativeHandle();
+                if (!Renderer::Initialize(rparams, wparams.backend == WindowBackend::HEADLESS))
+                    return false;
+            }
+
+            return true;
+        }
+
+        void Application::LoadSettings(const SettingsSnapshot& settings)
+        {
+            m_settingsVersion = settings.version;
+            m_targetFPS = settings.targetFPS;
+            m_spinMicroseconds = settings.spinMicroseconds;
+            m_pacing = settings.pacing;
+            m_backgroundFPS = settings.backgroundFPS;
+            m_throttleUnfocused = settings.throttleUnfocused;
+            m_eventTimeoutMs = settings.eventTimeoutMs;
+            m_resizeDebounceTicks = Time::SecondsToTicks(settings.resizeDebounceMs / 1000.0);
+            m_streamingBudgetTicks = Time::SecondsToTicks(settings.streamingBudgetUs / 1000000.0);
+            for (uint32_t i = 0; i < 4; i++)
+                m_clearColor[i] = settings.clearColor[i];
+            m_startupReportPath = settings.startupReport;
+            m_printStartup = settings.printStartup;
+        }
+
+        void Application::ApplySettings(const SettingsSnapshot& settings)
+        {
+            /*
+            * Only values that can change under a running instance are applied;
+            * window geometry, backends, arena size and the render thread need
+            * a restart.
+            */
+            LoadSettings(settings);
+            SetBackground(m_background);
+            Window::SetDisplayFPS(settings.window.displayFPS);
+
+            /*No jobs are in flight between frames, so the pool can be rebuilt*/
+            if (settings.workerCount != m_workerCount)
+            {
+                JobSystem::DeInitialize();
+                if (JobSystem::Initialize(settings.workerCount))
+                {
+                    m_workerCount = settings.workerCount;
+                }
+                else
+                {
+#ifdef _DEBUG
+                    Core::DebugPrintF("Failed to start %d worker(s), keeping %d\n", settings.workerCount, m_workerCount);
+#endif
+                    JobSystem::Initialize(m_workerCount);
+                }
+                m_world.SetThreadCount(JobSystem::ThreadCount());
+            }
+
+            /*The grid is rebuilt every step anyway, so its shape can change freely*/
+            m_broadphase.Configure(settings.broadphase);
+
+            ResourceCache::SetBudget(settings.resourceBudgetBytes);
+        }
+
+        void Application::ReportStartup()
+        {
+            m_startupTrace.EndPhase(m_firstFramePhase);
+            m_startupTrace.Finish();
+            m_firstFramePhase = StartupTrace::MAX_PHASES;
+
+            if (!m_startupReportPath.empty())
+                m_startupTrace.Write(m_startupReportPath);
+            if (m_printStartup)
+                m_startupTrace.Dump();
+        }
+
         void Application::DeInitialize()
         {
+            if (Renderer::IsThreaded())
+            {
+                Renderer::StopThread();
+                Window::MakeContextCurrent(true);
+            }
             Renderer::DeInitialize();
             Window::DeInitialize();
+            ResourceCache::DeInitialize();
+            AssetStreamer::DeInitialize();
+            Replay::DeInitialize();
+            JobSystem::DeInitialize();
+            Input::DeInitialize();
+            EventBus::Unsubscribe(m_resizeSubscription);
+            EventBus::DeInitialize();
+            m_world.DeInitialize();
+            m_frameArena.DeInitialize();
+            Settings::DeInitialize();
+        }
+
+        void Application::Update()
+        {
+            /*
+            * Fixed-rate simulation step. Runs Time::FixedDeltaTime() seconds
+            * of game time; rendering blends states with Time::InterpolationAlpha().
+            * Systems query m_world here and record structural changes into
+            * m_world.Commands(), which are applied after the step.
+            */
+        }
+
+        void Application::PublishRenderView()
+        {
+            /*Hand the render side this frame's view without blocking on it*/
+            RenderView& view = Renderer::BeginView();
+            view.frameIndex = Time::FrameIndex();
+            view.interpolationAlpha = Time::InterpolationAlpha();
+            for (uint32_t i = 0; i < 4; i++)
+                view.clearColor[i] = m_clearColor[i];
+            Renderer::PublishView();
+        }
+
+        void Application::SetBackground(bool background)
+        {
+            m_background = background;
+
+            /*
+            * An event-driven loop can block for a whole timeout between frames,
+            * so the catch-up cap has to cover that wait or the time is dropped.
+            */
+            uint32_t maxSteps = m_maxUpdateSteps;
+            if (m_eventDriven)
+            {
+                uint32_t stepsPerWait = static_cast<uint32_t>(std::ceil(m_eventTimeoutMs * m_updateRate / 1000.0)) + 1;
+                maxSteps = std::max(maxSteps, stepsPerWait);
+            }
+
+            if (!background)
+            {
+                Time::SetFixedTimeStep(1.0f / static_cast<float>(m_updateRate), maxSteps);
+                Time::SetFramePacing(m_targetFPS, m_spinMicroseconds, m_pacing);
+                return;
+            }
+
+            /*
+            * Frames get long in the background, so let the catch-up cap cover
+            * a whole background frame or simulation would silently lose time.
+            */
+            uint32_t stepsPerFrame = static_cast<uint32_t>(std::ceil(m_updateRate / m_backgroundFPS)) + 1;
+            Time::SetFixedTimeStep(1.0f / static_cast<float>(m_updateRate), std::max(maxSteps, stepsPerFrame));
+            Time::SetFramePacing(m_backgroundFPS, m_spinMicroseconds, PacingMode::FIXED);
+        }
+
+        void Application::OnWindowResized(const Event* events, uint32_t count, void* userData)
+        {
+            Application* app = static_cast<Application*>(userData);
+
+            /*Only the last size of the batch matters; every new one restarts the debounce*/
+            const Event& last = events[count - 1];
+            if (last.window.x <= 0 || last.window.y <= 0)
+                return;
+
+            app->m_resizeWidth = static_cast<uint32_t>(last.window.x);
+            app->m_resizeHeight = static_cast<uint32_t>(last.window.y);
+            app->m_resizeTick = Time::TotalTicks();
+            app->m_resizePending = true;
+        }
+
+        bool Application::ResizeDue()
+        {
+            /*Frame time rather than the clock, so a replay applies it on the same frame*/
+            return m_resizePending && Time::TotalTicks() - m_resizeTick >= m_resizeDebounceTicks;
+        }
+
+        void Application::ApplyPendingResize(RenderCommandBuffer& commands)
+        {
+            if (!ResizeDue())
+                return;
+
+            /*Recorded first so the rest of the frame already targets the new size*/
+            commands.ResizeBuffers(m_resizeWidth, m_resizeHeight);
+            m_resizePending = false;
+        }
+
+        uint32_t Application::EventWaitTimeout()
+        {
+            if (!m_resizePending)
+                return m_eventTimeoutMs;
+
+            /*Wake up in time to apply a debounced resize even if no further events come*/
+            uint64_t elapsed = Time::TotalTicks() - m_resizeTick;
+            uint64_t remaining = elapsed < m_resizeDebounceTicks ? m_resizeDebounceTicks - elapsed : 0;
+            uint32_t remainingMs = static_cast<uint32_t>(Time::TicksToSeconds(remaining) * 1000.0) + 1;
+
+            return std::min(m_eventTimeoutMs, remainingMs);
         }
   }
 
@@ -0,0 +1,135 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+
+#include <ht_archetype.h>
+
+#include <cstring>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        static uint32_t AlignUp(uint32_t value, uint32_t alignment)
+        {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+
+        Archetype::Archetype(ComponentMask mask)
+        {
+            m_mask = mask;
+            m_componentCount = 0;
+            for (ComponentId id = 0; id < MAX_COMPONENTS; id++)
+            {
+                m_offsets[id] = 0;
+                m_addEdges[id] = nullptr;
+                m_removeEdges[id] = nullptr;
+                if (Has(id))
+                    m_components[m_componentCount++] = id;
+            }
+
+            /*Largest row count whose aligned columns still fit in one chunk*/
+            uint32_t rowBytes = sizeof(Entity);
+            for (uint32_t i = 0; i < m_componentCount; i++)
+                rowBytes += ComponentRegistry::Info(m_components[i]).size;
+
+            m_capacity = CHUNK_SIZE / rowBytes;
+            while (m_capacity > 1 && Layout(m_capacity) > CHUNK_SIZE)
+                m_capacity--;
+            if (m_capacity == 0)
+                m_capacity = 1;
+            m_chunkBytes = Layout(m_capacity);
+
+            m_usedChunks = 0;
+            m_entityCount = 0;
+        }
+
+        Archetype::~Archetype()
+        {
+            for (size_t i = 0; i < m_chunks.size(); i++)
+                delete[] m_chunks[i].memory;
+        }
+
+        uint32_t Archetype::Layout(uint32_t capacity)
+        {
+            uint32_t offset = AlignUp(capacity * static_cast<uint32_t>(sizeof(Entity)), COLUMN_ALIGNMENT);
+            for (uint32_t i = 0; i < m_componentCount; i++)
+            {
+                ComponentId id = m_components[i];
+                m_offsets[id] = offset;
+                offset = AlignUp(offset + capacity * ComponentRegistry::Info(id).size, COLUMN_ALIGNMENT);
+            }
+
+            return offset;
+        }
+
+        void* Archetype::Component(uint32_t chunk, uint32_t row, ComponentId id) const
+        {
+            return m_chunks[chunk].data + m_offsets[id] + row * ComponentRegistry::Info(id).size;
+        }
+
+        void Archetype::Append(Entity entity, uint32_t& chunk, uint32_t& row)
+        {
+            if (m_usedChunks == 0 || m_chunks[m_usedChunks - 1].count == m_capacity)
+            {
+                /*Emptied chunks are kept around for reuse*/
+                if (m_usedChunks == m_chunks.size())
+                {
+                    Chunk created;
+                    created.memory = new uint8_t[m_chunkBytes + COLUMN_ALIGNMENT];
+                    uintptr_t address = reinterpret_cast<uintptr_t>(created.memory);
+                    created.data = reinterpret_cast<uint8_t*>((address + COLUMN_ALIGNMENT - 1) & ~static_cast<uintptr_t>(COLUMN_ALIGNMENT - 1));
+                    created.count = 0;
+                    m_chunks.push_back(created);
+                }
+                m_usedChunks++;
+            }
+
+            chunk = m_usedChunks - 1;
+            Chunk& target = m_chunks[chunk];
+            row = target.count++;
+            Entities(target)[row] = entity;
+            m_entityCount++;
+        }
+
+        Entity Archetype::RemoveSwap(uint32_t chunk, uint32_t row)
+        {
+            Chunk& last = m_chunks[m_usedChunks - 1];
+            uint32_t lastRow = last.count - 1;
+
+            Entity moved = NULL_ENTITY;
+            if (chunk != m_usedChunks - 1 || row != lastRow)
+            {
+                Chunk& target = m_chunks[chunk];
+                moved = Entities(last)[lastRow];
+                Entities(target)[row] = moved;
+                for (uint32_t i = 0; i < m_componentCount; i++)
+                {
+                    ComponentId id = m_components[i];
+                    uint32_t size = ComponentRegistry::Info(id).size;
+                    std::memcpy(target.data + m_offsets[id] + row * size, last.data + m_offsets[id] + lastRow * size, size);
+                }
+            }
+
+            last.count--;
+            if (last.count == 0)
+                m_usedChunks--;
+            m_entityCount--;
+
+            return moved;
+        }
+
+    }
+
+}
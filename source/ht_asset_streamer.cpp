@@ -0,0 +1,266 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+
+#include <ht_asset_streamer.h>
+#include <ht_time_singleton.h>
+#include <ht_debug.h>
+
+#include <algorithm>
+#include <new>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        AssetStreamer::AssetStreamer()
+        {
+            m_available = 0;
+            m_stopping = false;
+        }
+
+        bool AssetStreamer::Initialize(uint32_t threadCount, uint32_t capacity)
+        {
+            AssetStreamer& _instance = AssetStreamer::instance();
+
+            capacity = std::max(capacity, 1u);
+
+            /*Requests are preallocated so Load never touches the heap on the main thread*/
+            _instance.m_requests.resize(capacity);
+            _instance.m_free.clear();
+            for (uint32_t i = capacity; i > 0; i--)
+                _instance.m_free.push_back(&_instance.m_requests[i - 1]);
+
+            if (!_instance.m_queued.Initialize(capacity) || !_instance.m_completed.Initialize(capacity))
+                return false;
+
+            _instance.m_available = 0;
+            _instance.m_stopping = false;
+            threadCount = std::max(threadCount, 1u);
+            for (uint32_t i = 0; i < threadCount; i++)
+                _instance.m_workers.push_back(std::thread(&AssetStreamer::WorkerMain));
+
+#ifdef _DEBUG
+            Core::DebugPrintF("Asset streamer started with %u thread(s)\n", threadCount);
+#endif
+
+            return true;
+        }
+
+        void AssetStreamer::DeInitialize()
+        {
+            AssetStreamer& _instance = AssetStreamer::instance();
+
+            /*Workers drain what was queued before they stop; undelivered callbacks are dropped*/
+            {
+                std::lock_guard<std::mutex> lock(_instance.m_lock);
+                _instance.m_stopping = true;
+            }
+            _instance.m_wake.notify_all();
+
+            for (size_t i = 0; i < _instance.m_workers.size(); i++)
+                _instance.m_workers[i].join();
+            _instance.m_workers.clear();
+
+            _instance.m_queued.DeInitialize();
+            _instance.m_completed.DeInitialize();
+            _instance.m_free.clear();
+            _instance.m_requests.clear();
+
+            for (size_t i = 0; i < _instance.m_packs.size(); i++)
+                delete _instance.m_packs[i];
+            _instance.m_packs.clear();
+        }
+
+        bool AssetStreamer::Mount(const std::string& path)
+        {
+            AssetStreamer& _instance = AssetStreamer::instance();
+
+            PackFile* pack = new PackFile;
+            if (!pack->Open(path))
+            {
+                delete pack;
+                return false;
+            }
+
+            _instance.m_packs.push_back(pack);
+
+#ifdef _DEBUG
+            Core::DebugPrintF("Mounted pack %s (%u entries)\n", path.c_str(), pack->EntryCount());
+#endif
+
+            return true;
+        }
+
+        bool AssetStreamer::Contains(const std::string& name)
+        {
+            return Contains(PackFile::Hash(name));
+        }
+
+        bool AssetStreamer::Contains(uint64_t id)
+        {
+            const PackFile* pack;
+            return Find(id, pack) != nullptr;
+        }
+
+        bool AssetStreamer::Load(const std::string& name, AssetCallback callback, void* userData)
+        {
+            return Load(PackFile::Hash(name), callback, userData);
+        }
+
+        bool AssetStreamer::Load(uint64_t id, AssetCallback callback, void* userData)
+        {
+            AssetStreamer& _instance = AssetStreamer::instance();
+
+            const PackFile* pack;
+            const PackEntry* entry = Find(id, pack);
+            if (!entry || _instance.m_free.empty())
+                return false;
+
+            Request* request = _instance.m_free.back();
+            _instance.m_free.pop_back();
+            request->pack = pack;
+            request->entry = entry;
+            request->callback = callback;
+            request->userData = userData;
+            request->asset.id = id;
+            request->asset.data = nullptr;
+            request->asset.size = 0;
+            request->asset.loaded = false;
+
+            /*In-flight requests never exceed capacity, so neither queue can fill*/
+            _instance.m_queued.Push(request);
+            {
+                std::lock_guard<std::mutex> lock(_instance.m_lock);
+                _instance.m_available++;
+            }
+            _instance.m_wake.notify_one();
+
+            return true;
+        }
+
+        uint32_t AssetStreamer::Dispatch(uint64_t budgetTicks)
+        {
+            AssetStreamer& _instance = AssetStreamer::instance();
+
+            uint64_t start = Time::Ticks();
+            uint32_t delivered = 0;
+
+            Request* request;
+            while (_instance.m_completed.Pop(request))
+            {
+                request->callback(request->asset, request->userData);
+
+                /*Release whatever the callback did not take*/
+                std::vector<uint8_t>().swap(request->asset.buffer);
+                _instance.m_free.push_back(request);
+                delivered++;
+
+                if (Time::Ticks() - start >= budgetTicks)
+                    break;
+            }
+
+            return delivered;
+        }
+
+        uint32_t AssetStreamer::Pending()
+        {
+            AssetStreamer& _instance = AssetStreamer::instance();
+
+            return static_cast<uint32_t>(_instance.m_requests.size() - _instance.m_free.size());
+        }
+
+        const PackEntry* AssetStreamer::Find(uint64_t id, const PackFile*& pack)
+        {
+            AssetStreamer& _instance = AssetStreamer::instance();
+
+            for (size_t i = _instance.m_packs.size(); i > 0; i--)
+            {
+                const PackEntry* entry = _instance.m_packs[i - 1]->Find(id);
+                if (entry)
+                {
+                    pack = _instance.m_packs[i - 1];
+                    return entry;
+                }
+            }
+
+            pack = nullptr;
+            return nullptr;
+        }
+
+        void AssetStreamer::WorkerMain()
+        {
+            AssetStreamer& _instance = AssetStreamer::instance();
+
+            for (;;)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(_instance.m_lock);
+                    _instance.m_wake.wait(lock, [&_instance]() { return _instance.m_stopping || _instance.m_available > 0; });
+                    if (_instance.m_available == 0)
+                        return;
+                    _instance.m_available--;
+                }
+
+                Request* request;
+                if (_instance.m_queued.Pop(request))
+                {
+                    Process(request);
+                    _instance.m_completed.Push(request);
+                }
+            }
+        }
+
+        void AssetStreamer::Process(Request* request)
+        {
+            const PackEntry& entry = *request->entry;
+            StreamedAsset& asset = request->asset;
+
+            asset.size = entry.size;
+            if (entry.flags & PackFile::COMPRESSED)
+            {
+                /*Running out of memory fails this load instead of terminating the streaming thread*/
+                try
+                {
+                    asset.buffer.resize(entry.size);
+                    asset.loaded = request->pack->Read(entry, asset.buffer.data());
+                }
+                catch (const std::bad_alloc&)
+                {
+                    asset.loaded = false;
+                }
+                asset.data = asset.buffer.data();
+            }
+            else
+            {
+                /*Zero-copy: the callback reads the mapping, so fault it in here instead*/
+                request->pack->Prefetch(entry);
+                asset.data = request->pack->Data(entry);
+                asset.loaded = true;
+            }
+
+            if (!asset.loaded)
+            {
+                asset.size = 0;
+                std::vector<uint8_t>().swap(asset.buffer);
+#ifdef _DEBUG
+                Core::DebugPrintF("Pack entry %016llx in %s failed to decompress\n",
+                    static_cast<unsigned long long>(asset.id), request->pack->Path().c_str());
+#endif
+            }
+        }
+
+    }
+
+}
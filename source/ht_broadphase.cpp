@@ -0,0 +1,736 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+
+#include <ht_broadphase.h>
+#include <ht_jobsystem.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HT_BROADPHASE_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace Hatchit {
+
+    namespace Game {
+
+        const ProxyId Broadphase::INVALID;
+        const uint32_t Broadphase::PAIR_BATCH;
+        const uint32_t Broadphase::MAX_CELLS;
+
+        static const uint32_t OVERSIZE = 0xFFFFFFFF;
+        static const uint32_t UNSEEN = 0xFFFFFFFE;
+
+        static inline bool Overlaps(const Bounds& a, const Bounds& b)
+        {
+            return a.min[0] <= b.max[0] && b.min[0] <= a.max[0] &&
+                   a.min[1] <= b.max[1] && b.min[1] <= a.max[1] &&
+                   a.min[2] <= b.max[2] && b.min[2] <= a.max[2];
+        }
+
+        static inline bool Overlaps(const float* const sorted[6], uint32_t i, const Bounds& b)
+        {
+            return sorted[0][i] <= b.max[0] && b.min[0] <= sorted[3][i] &&
+                   sorted[1][i] <= b.max[1] && b.min[1] <= sorted[4][i] &&
+                   sorted[2][i] <= b.max[2] && b.min[2] <= sorted[5][i];
+        }
+
+        static inline bool Overlaps(const float* const sorted[6], uint32_t i, uint32_t j)
+        {
+            return sorted[0][i] <= sorted[3][j] && sorted[0][j] <= sorted[3][i] &&
+                   sorted[1][i] <= sorted[4][j] && sorted[1][j] <= sorted[4][i] &&
+                   sorted[2][i] <= sorted[5][j] && sorted[2][j] <= sorted[5][i];
+        }
+
+        static inline float DistanceSquared(const float point[3], const float min[3], const float max[3])
+        {
+            float distance = 0.0f;
+            for (uint32_t a = 0; a < 3; a++)
+            {
+                float d = std::max(std::max(min[a] - point[a], point[a] - max[a]), 0.0f);
+                distance += d * d;
+            }
+            return distance;
+        }
+
+        /*Slab test of the segment [0, maxDistance] against a box; returns the entry and exit distances*/
+        static bool RaySlab(const float origin[3], const float direction[3], float maxDistance,
+                            const float min[3], const float max[3], float& enter, float& exit)
+        {
+            enter = 0.0f;
+            exit = maxDistance;
+            for (uint32_t a = 0; a < 3; a++)
+            {
+                if (direction[a] == 0.0f)
+                {
+                    if (origin[a] < min[a] || origin[a] > max[a])
+                        return false;
+                    continue;
+                }
+
+                float inverse = 1.0f / direction[a];
+                float t0 = (min[a] - origin[a]) * inverse;
+                float t1 = (max[a] - origin[a]) * inverse;
+                if (t0 > t1)
+                    std::swap(t0, t1);
+
+                enter = std::max(enter, t0);
+                exit = std::min(exit, t1);
+                if (enter > exit)
+                    return false;
+            }
+            return true;
+        }
+
+        static inline void Record(ProxyId id, ProxyId* results, uint32_t capacity, uint32_t& found)
+        {
+            if (found < capacity)
+                results[found] = id;
+            found++;
+        }
+
+        static inline ProxyPair MakePair(ProxyId a, ProxyId b)
+        {
+            ProxyPair pair;
+            pair.a = std::min(a, b);
+            pair.b = std::max(a, b);
+            return pair;
+        }
+
+        /*Pairs slot i with every overlapping slot in [first, last), four at a time where SSE is available*/
+        static void TestRange(const float* const sorted[6], const ProxyId* ids, uint32_t i, uint32_t first, uint32_t last,
+                              std::vector<ProxyPair>& pairs)
+        {
+            uint32_t j = first;
+#ifdef HT_BROADPHASE_SSE
+            __m128 minX = _mm_set1_ps(sorted[0][i]);
+            __m128 minY = _mm_set1_ps(sorted[1][i]);
+            __m128 minZ = _mm_set1_ps(sorted[2][i]);
+            __m128 maxX = _mm_set1_ps(sorted[3][i]);
+            __m128 maxY = _mm_set1_ps(sorted[4][i]);
+            __m128 maxZ = _mm_set1_ps(sorted[5][i]);
+            for (; j + 4 <= last; j += 4)
+            {
+                __m128 x = _mm_and_ps(_mm_cmple_ps(minX, _mm_loadu_ps(sorted[3] + j)), _mm_cmple_ps(_mm_loadu_ps(sorted[0] + j), maxX));
+                __m128 y = _mm_and_ps(_mm_cmple_ps(minY, _mm_loadu_ps(sorted[4] + j)), _mm_cmple_ps(_mm_loadu_ps(sorted[1] + j), maxY));
+                __m128 z = _mm_and_ps(_mm_cmple_ps(minZ, _mm_loadu_ps(sorted[5] + j)), _mm_cmple_ps(_mm_loadu_ps(sorted[2] + j), maxZ));
+                int mask = _mm_movemask_ps(_mm_and_ps(_mm_and_ps(x, y), z));
+                if (!mask)
+                    continue;
+
+                for (uint32_t lane = 0; lane < 4; lane++)
+                {
+                    if (mask & (1 << lane))
+                        pairs.push_back(MakePair(ids[i], ids[j + lane]));
+                }
+            }
+#endif
+            for (; j < last; j++)
+            {
+                if (Overlaps(sorted, i, j))
+                    pairs.push_back(MakePair(ids[i], ids[j]));
+            }
+        }
+
+        template <typename Test>
+        void Broadphase::VisitCell(uint32_t cell, Test& test) const
+        {
+            uint32_t end = m_cellStart[cell + 1];
+            for (uint32_t i = m_cellStart[cell]; i < end; i++)
+                test(i);
+        }
+
+        template <typename Test>
+        void Broadphase::VisitCells(const uint32_t lo[3], const uint32_t hi[3], Test& test) const
+        {
+            for (uint32_t z = lo[2]; z <= hi[2]; z++)
+            {
+                for (uint32_t y = lo[1]; y <= hi[1]; y++)
+                {
+                    uint32_t row = (z * m_params.cells[1] + y) * m_params.cells[0];
+                    for (uint32_t x = lo[0]; x <= hi[0]; x++)
+                        VisitCell(row + x, test);
+                }
+            }
+        }
+
+        Broadphase::Broadphase()
+        {
+            BroadphaseParams params;
+            params.cellSize = 4.0f;
+            for (uint32_t a = 0; a < 3; a++)
+            {
+                params.cells[a] = 64;
+                params.origin[a] = -128.0f;
+            }
+
+            Configure(params);
+            m_params = m_requested;
+            m_inverseCellSize = 1.0f / m_params.cellSize;
+            m_cellCount = 0;
+            m_count = 0;
+        }
+
+        bool Broadphase::Configure(const BroadphaseParams& params)
+        {
+            if (!(params.cellSize > 0.0f))
+                return false;
+
+            uint64_t cells = 1;
+            for (uint32_t a = 0; a < 3; a++)
+                cells *= params.cells[a];
+            if (cells == 0 || cells > MAX_CELLS)
+                return false;
+
+            m_requested = params;
+            return true;
+        }
+
+        void Broadphase::Reserve(uint32_t count)
+        {
+            m_bounds.reserve(count);
+            m_alive.reserve(count);
+            m_cellOf.reserve(count);
+            m_order.reserve(count);
+            for (uint32_t c = 0; c < CHANNEL_COUNT; c++)
+                m_sorted[c].reserve(count);
+            m_sortedIds.reserve(count);
+        }
+
+        ProxyId Broadphase::Insert(const Bounds& bounds)
+        {
+            ProxyId id;
+            if (!m_freeIds.empty())
+            {
+                id = m_freeIds.back();
+                m_freeIds.pop_back();
+            }
+            else
+            {
+                id = static_cast<ProxyId>(m_bounds.size());
+                m_bounds.push_back(bounds);
+                m_alive.push_back(0);
+            }
+
+            m_bounds[id] = bounds;
+            m_alive[id] = 1;
+            m_count++;
+
+            return id;
+        }
+
+        void Broadphase::Insert(const Bounds* bounds, uint32_t count, ProxyId* ids)
+        {
+            if (m_freeIds.size() < count)
+            {
+                size_t grown = m_bounds.size() + count - m_freeIds.size();
+                m_bounds.reserve(grown);
+                m_alive.reserve(grown);
+            }
+
+            for (uint32_t i = 0; i < count; i++)
+                ids[i] = Insert(bounds[i]);
+        }
+
+        void Broadphase::Move(ProxyId id, const Bounds& bounds)
+        {
+            if (Alive(id))
+                m_bounds[id] = bounds;
+        }
+
+        void Broadphase::Move(const ProxyId* ids, const Bounds* bounds, uint32_t count)
+        {
+            for (uint32_t i = 0; i < count; i++)
+                Move(ids[i], bounds[i]);
+        }
+
+        void Broadphase::Remove(ProxyId id)
+        {
+            if (!Alive(id))
+                return;
+
+            m_alive[id] = 0;
+            m_removed.push_back(id);
+            m_count--;
+        }
+
+        void Broadphase::Remove(const ProxyId* ids, uint32_t count)
+        {
+            for (uint32_t i = 0; i < count; i++)
+                Remove(ids[i]);
+        }
+
+        const Bounds& Broadphase::GetBounds(ProxyId id) const
+        {
+            return m_bounds[id];
+        }
+
+        void Broadphase::Update()
+        {
+            /*Removed ids were still referenced by the old grid until now*/
+            m_freeIds.insert(m_freeIds.end(), m_removed.begin(), m_removed.end());
+            m_removed.clear();
+
+            /*Nothing in the grid and nothing to add: skip clearing every cell*/
+            if (m_count == 0 && m_occupied.empty() && m_oversize.empty())
+            {
+                m_pairs.clear();
+                return;
+            }
+
+            Rebuild();
+            FindPairs();
+        }
+
+        uint32_t Broadphase::QueryAABB(const Bounds& bounds, ProxyId* results, uint32_t capacity) const
+        {
+            uint32_t found = 0;
+
+            for (size_t k = 0; k < m_oversize.size(); k++)
+            {
+                if (Overlaps(m_oversizeBounds[k], bounds))
+                    Record(m_oversize[k], results, capacity, found);
+            }
+
+            uint32_t lo[3];
+            uint32_t hi[3];
+            if (!CellRange(bounds, m_params.cellSize * 0.5f, lo, hi))
+                return found;
+
+            const float* const sorted[CHANNEL_COUNT] = { m_sorted[0].data(), m_sorted[1].data(), m_sorted[2].data(),
+                                                         m_sorted[3].data(), m_sorted[4].data(), m_sorted[5].data() };
+            const ProxyId* ids = m_sortedIds.data();
+            auto test = [&](uint32_t i)
+            {
+                if (Overlaps(sorted, i, bounds))
+                    Record(ids[i], results, capacity, found);
+            };
+            VisitCells(lo, hi, test);
+
+            return found;
+        }
+
+        uint32_t Broadphase::QueryRadius(const float center[3], float radius, ProxyId* results, uint32_t capacity) const
+        {
+            uint32_t found = 0;
+            float radiusSquared = radius * radius;
+
+            for (size_t k = 0; k < m_oversize.size(); k++)
+            {
+                if (DistanceSquared(center, m_oversizeBounds[k].min, m_oversizeBounds[k].max) <= radiusSquared)
+                    Record(m_oversize[k], results, capacity, found);
+            }
+
+            Bounds bounds;
+            for (uint32_t a = 0; a < 3; a++)
+            {
+                bounds.min[a] = center[a] - radius;
+                bounds.max[a] = center[a] + radius;
+            }
+
+            uint32_t lo[3];
+            uint32_t hi[3];
+            if (!CellRange(bounds, m_params.cellSize * 0.5f, lo, hi))
+                return found;
+
+            const ProxyId* ids = m_sortedIds.data();
+            auto test = [&](uint32_t i)
+            {
+                float min[3] = { m_sorted[MIN_X][i], m_sorted[MIN_Y][i], m_sorted[MIN_Z][i] };
+                float max[3] = { m_sorted[MAX_X][i], m_sorted[MAX_Y][i], m_sorted[MAX_Z][i] };
+                if (DistanceSquared(center, min, max) <= radiusSquared)
+                    Record(ids[i], results, capacity, found);
+            };
+            VisitCells(lo, hi, test);
+
+            return found;
+        }
+
+        uint32_t Broadphase::QueryRay(const float origin[3], const float direction[3], float maxDistance,
+                                      RayHit* results, uint32_t capacity) const
+        {
+            uint32_t found = 0;
+
+            float length = std::sqrt(direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2]);
+            if (!(length > 0.0f) || maxDistance < 0.0f)
+                return 0;
+            float dir[3] = { direction[0] / length, direction[1] / length, direction[2] / length };
+
+            auto hit = [&](ProxyId id, const float min[3], const float max[3])
+            {
+                float enter;
+                float exit;
+                if (!RaySlab(origin, dir, maxDistance, min, max, enter, exit))
+                    return;
+                if (found < capacity)
+                {
+                    results[found].proxy = id;
+                    results[found].distance = enter;
+                }
+                found++;
+            };
+
+            for (size_t k = 0; k < m_oversize.size(); k++)
+                hit(m_oversize[k], m_oversizeBounds[k].min, m_oversizeBounds[k].max);
+
+            if (m_occupied.empty())
+                return found;
+
+            /*Clip the ray to the grid widened by the loose margin*/
+            float cellSize = m_params.cellSize;
+            float margin = cellSize * 0.5f;
+            float gridMin[3];
+            float gridMax[3];
+            for (uint32_t a = 0; a < 3; a++)
+            {
+                gridMin[a] = m_params.origin[a] - margin;
+                gridMax[a] = m_params.origin[a] + m_params.cells[a] * cellSize + margin;
+            }
+
+            float enter;
+            float exit;
+            if (!RaySlab(origin, dir, maxDistance, gridMin, gridMax, enter, exit))
+                return found;
+
+            /*
+            * Walk the cells under the ray (3D DDA), visiting each one's
+            * neighbourhood since contents spill half a cell. A step along one
+            * axis only brings in the 3x3 slab ahead, so no cell is seen twice.
+            */
+            int32_t cell[3];
+            int32_t step[3];
+            float next[3];
+            float delta[3];
+            for (uint32_t a = 0; a < 3; a++)
+            {
+                float start = origin[a] + dir[a] * enter;
+                float f = std::floor((start - m_params.origin[a]) * m_inverseCellSize);
+                f = std::min(std::max(f, -1.0f), static_cast<float>(m_params.cells[a]));
+                cell[a] = static_cast<int32_t>(f);
+
+                if (dir[a] > 0.0f)
+                {
+                    step[a] = 1;
+                    next[a] = enter + (m_params.origin[a] + (cell[a] + 1) * cellSize - start) / dir[a];
+                    delta[a] = cellSize / dir[a];
+                }
+                else if (dir[a] < 0.0f)
+                {
+                    step[a] = -1;
+                    next[a] = enter + (m_params.origin[a] + cell[a] * cellSize - start) / dir[a];
+                    delta[a] = -cellSize / dir[a];
+                }
+                else
+                {
+                    step[a] = 0;
+                    next[a] = std::numeric_limits<float>::infinity();
+                    delta[a] = std::numeric_limits<float>::infinity();
+                }
+            }
+
+            const ProxyId* ids = m_sortedIds.data();
+            auto test = [&](uint32_t i)
+            {
+                float min[3] = { m_sorted[MIN_X][i], m_sorted[MIN_Y][i], m_sorted[MIN_Z][i] };
+                float max[3] = { m_sorted[MAX_X][i], m_sorted[MAX_Y][i], m_sorted[MAX_Z][i] };
+                hit(ids[i], min, max);
+            };
+            auto visitBlock = [&](const int32_t first[3], const int32_t last[3])
+            {
+                uint32_t lo[3];
+                uint32_t hi[3];
+                for (uint32_t a = 0; a < 3; a++)
+                {
+                    int32_t cells = static_cast<int32_t>(m_params.cells[a]);
+                    if (last[a] < 0 || first[a] >= cells)
+                        return;
+                    lo[a] = static_cast<uint32_t>(std::max(first[a], 0));
+                    hi[a] = static_cast<uint32_t>(std::min(last[a], cells - 1));
+                }
+                VisitCells(lo, hi, test);
+            };
+
+            int32_t first[3] = { cell[0] - 1, cell[1] - 1, cell[2] - 1 };
+            int32_t last[3] = { cell[0] + 1, cell[1] + 1, cell[2] + 1 };
+            visitBlock(first, last);
+
+            for (;;)
+            {
+                uint32_t axis = (next[0] < next[1]) ? ((next[0] < next[2]) ? 0 : 2) : ((next[1] < next[2]) ? 1 : 2);
+                if (next[axis] > exit)
+                    break;
+
+                cell[axis] += step[axis];
+                next[axis] += delta[axis];
+                if (cell[axis] < -1 || cell[axis] > static_cast<int32_t>(m_params.cells[axis]))
+                    break;
+
+                for (uint32_t a = 0; a < 3; a++)
+                {
+                    first[a] = cell[a] - 1;
+                    last[a] = cell[a] + 1;
+                }
+                first[axis] = last[axis] = cell[axis] + step[axis];
+                visitBlock(first, last);
+            }
+
+            return found;
+        }
+
+        const ProxyPair* Broadphase::Pairs() const
+        {
+            return m_pairs.data();
+        }
+
+        uint32_t Broadphase::PairCount() const
+        {
+            return static_cast<uint32_t>(m_pairs.size());
+        }
+
+        uint32_t Broadphase::Count() const
+        {
+            return m_count;
+        }
+
+        bool Broadphase::Alive(ProxyId id) const
+        {
+            return id < m_alive.size() && m_alive[id];
+        }
+
+        void Broadphase::Rebuild()
+        {
+            m_params = m_requested;
+            m_inverseCellSize = 1.0f / m_params.cellSize;
+            m_cellCount = m_params.cells[0] * m_params.cells[1] * m_params.cells[2];
+
+            m_cellStart.assign(m_cellCount + 1, 0);
+            m_cellOf.assign(m_bounds.size(), UNSEEN);
+            m_order.clear();
+
+            /*
+            * Proxies are binned in last step's cell order: most stay put, so
+            * the counting sort below walks the cells nearly in sequence.
+            * New proxies follow in id order.
+            */
+            for (size_t i = 0; i < m_sortedIds.size(); i++)
+                Bin(m_sortedIds[i]);
+            for (size_t i = 0; i < m_oversize.size(); i++)
+                Bin(m_oversize[i]);
+            for (ProxyId id = 0; id < m_bounds.size(); id++)
+                Bin(id);
+
+            /*
+            * Counting sort: a running sum turns each cell's count into its
+            * end, then scattering backwards walks every end down to the
+            * cell's start and keeps the binning order within a cell.
+            */
+            m_occupied.clear();
+            uint32_t gridCount = 0;
+            for (uint32_t c = 0; c < m_cellCount; c++)
+            {
+                if (m_cellStart[c])
+                    m_occupied.push_back(c);
+                gridCount += m_cellStart[c];
+                m_cellStart[c] = gridCount;
+            }
+            m_cellStart[m_cellCount] = gridCount;
+
+            for (uint32_t c = 0; c < CHANNEL_COUNT; c++)
+                m_sorted[c].resize(gridCount);
+            m_sortedIds.resize(gridCount);
+
+            m_oversize.clear();
+            m_oversizeBounds.clear();
+            for (size_t i = m_order.size(); i > 0; i--)
+            {
+                ProxyId id = m_order[i - 1];
+                uint32_t cell = m_cellOf[id];
+                const Bounds& bounds = m_bounds[id];
+                if (cell == OVERSIZE)
+                {
+                    m_oversize.push_back(id);
+                    m_oversizeBounds.push_back(bounds);
+                    continue;
+                }
+
+                uint32_t slot = --m_cellStart[cell];
+                m_sorted[MIN_X][slot] = bounds.min[0];
+                m_sorted[MIN_Y][slot] = bounds.min[1];
+                m_sorted[MIN_Z][slot] = bounds.min[2];
+                m_sorted[MAX_X][slot] = bounds.max[0];
+                m_sorted[MAX_Y][slot] = bounds.max[1];
+                m_sorted[MAX_Z][slot] = bounds.max[2];
+                m_sortedIds[slot] = id;
+            }
+            std::reverse(m_oversize.begin(), m_oversize.end());
+            std::reverse(m_oversizeBounds.begin(), m_oversizeBounds.end());
+        }
+
+        void Broadphase::Bin(ProxyId id)
+        {
+            if (m_cellOf[id] != UNSEEN || !m_alive[id])
+                return;
+
+            /*Bin by center; anything wider than a cell or outside the grid goes on the oversize list*/
+            const Bounds& bounds = m_bounds[id];
+            uint32_t cell = 0;
+            for (int32_t a = 2; a >= 0; a--)
+            {
+                float extent = bounds.max[a] - bounds.min[a];
+                float f = ((bounds.min[a] + bounds.max[a]) * 0.5f - m_params.origin[a]) * m_inverseCellSize;
+                if (!(extent <= m_params.cellSize) || !(f >= 0.0f) || !(f < static_cast<float>(m_params.cells[a])))
+                {
+                    cell = OVERSIZE;
+                    break;
+                }
+                cell = cell * m_params.cells[a] + static_cast<uint32_t>(f);
+            }
+
+            m_cellOf[id] = cell;
+            m_order.push_back(id);
+            if (cell != OVERSIZE)
+                m_cellStart[cell]++;
+        }
+
+        void Broadphase::FindPairs()
+        {
+            uint32_t batches = (static_cast<uint32_t>(m_occupied.size()) + PAIR_BATCH - 1) / PAIR_BATCH;
+            if (m_batchPairs.size() < batches)
+                m_batchPairs.resize(batches);
+
+            if (batches > 1)
+                JobSystem::ParallelFor(batches, 1, &Broadphase::FindPairsBatch, this);
+            else if (batches == 1)
+                FindPairsBatch(0, 1, this);
+
+            m_pairs.clear();
+            for (uint32_t b = 0; b < batches; b++)
+                m_pairs.insert(m_pairs.end(), m_batchPairs[b].begin(), m_batchPairs[b].end());
+
+            /*Oversize proxies are few; test them against the grid and each other here*/
+            const ProxyId* ids = m_sortedIds.data();
+            const float* const sorted[CHANNEL_COUNT] = { m_sorted[0].data(), m_sorted[1].data(), m_sorted[2].data(),
+                                                         m_sorted[3].data(), m_sorted[4].data(), m_sorted[5].data() };
+            for (size_t k = 0; k < m_oversize.size(); k++)
+            {
+                const Bounds& bounds = m_oversizeBounds[k];
+                ProxyId id = m_oversize[k];
+
+                for (size_t l = k + 1; l < m_oversize.size(); l++)
+                {
+                    if (Overlaps(bounds, m_oversizeBounds[l]))
+                        m_pairs.push_back(MakePair(id, m_oversize[l]));
+                }
+
+                uint32_t lo[3];
+                uint32_t hi[3];
+                if (!CellRange(bounds, m_params.cellSize * 0.5f, lo, hi))
+                    continue;
+
+                auto test = [&](uint32_t i)
+                {
+                    if (Overlaps(sorted, i, bounds))
+                        m_pairs.push_back(MakePair(id, ids[i]));
+                };
+                VisitCells(lo, hi, test);
+            }
+        }
+
+        void Broadphase::FindPairsBatch(uint32_t begin, uint32_t end, void* data)
+        {
+            Broadphase* broadphase = static_cast<Broadphase*>(data);
+
+            uint32_t occupied = static_cast<uint32_t>(broadphase->m_occupied.size());
+            for (uint32_t b = begin; b < end; b++)
+            {
+                std::vector<ProxyPair>& pairs = broadphase->m_batchPairs[b];
+                pairs.clear();
+
+                uint32_t last = std::min(occupied, (b + 1) * PAIR_BATCH);
+                for (uint32_t i = b * PAIR_BATCH; i < last; i++)
+                    broadphase->FindCellPairs(broadphase->m_occupied[i], pairs);
+            }
+        }
+
+        void Broadphase::FindCellPairs(uint32_t cell, std::vector<ProxyPair>& pairs) const
+        {
+            const float* const sorted[CHANNEL_COUNT] = { m_sorted[0].data(), m_sorted[1].data(), m_sorted[2].data(),
+                                                         m_sorted[3].data(), m_sorted[4].data(), m_sorted[5].data() };
+            const ProxyId* ids = m_sortedIds.data();
+            const uint32_t* start = m_cellStart.data();
+
+            uint32_t cellsX = m_params.cells[0];
+            uint32_t cellsY = m_params.cells[1];
+            uint32_t cellsZ = m_params.cells[2];
+            uint32_t x = cell % cellsX;
+            uint32_t y = (cell / cellsX) % cellsY;
+            uint32_t z = cell / (cellsX * cellsY);
+
+            /*
+            * Contents spill at most half a cell, so only adjacent cells can
+            * pair. Each adjacent pair is visited from one side: x + 1 in this
+            * row, then the three cells around x in row y + 1 and in rows
+            * y - 1..y + 1 of plane z + 1. Cells x - 1..x + 1 of a row are
+            * contiguous in the sorted arrays, so each row is a single range.
+            */
+            uint32_t left = (x > 0) ? x - 1 : 0;
+            uint32_t right = (x + 1 < cellsX) ? x + 1 : x;
+
+            uint32_t rows[4];
+            uint32_t rowCount = 0;
+            if (y + 1 < cellsY)
+                rows[rowCount++] = (z * cellsY + y + 1) * cellsX;
+            if (z + 1 < cellsZ)
+            {
+                for (uint32_t ny = (y > 0) ? y - 1 : 0; ny <= y + 1 && ny < cellsY; ny++)
+                    rows[rowCount++] = ((z + 1) * cellsY + ny) * cellsX;
+            }
+
+            uint32_t begin = start[cell];
+            uint32_t end = start[cell + 1];
+            uint32_t rowEnd = start[cell - x + right + 1];
+            for (uint32_t i = begin; i < end; i++)
+            {
+                TestRange(sorted, ids, i, i + 1, rowEnd, pairs);
+                for (uint32_t r = 0; r < rowCount; r++)
+                    TestRange(sorted, ids, i, start[rows[r] + left], start[rows[r] + right + 1], pairs);
+            }
+        }
+
+        bool Broadphase::CellRange(const Bounds& bounds, float margin, uint32_t lo[3], uint32_t hi[3]) const
+        {
+            if (m_occupied.empty())
+                return false;
+
+            for (uint32_t a = 0; a < 3; a++)
+            {
+                float first = std::floor((bounds.min[a] - margin - m_params.origin[a]) * m_inverseCellSize);
+                float last = std::floor((bounds.max[a] + margin - m_params.origin[a]) * m_inverseCellSize);
+                float cells = static_cast<float>(m_params.cells[a]);
+                if (!(last >= 0.0f) || !(first < cells))
+                    return false;
+
+                lo[a] = first > 0.0f ? static_cast<uint32_t>(first) : 0;
+                hi[a] = last < cells - 1.0f ? static_cast<uint32_t>(last) : m_params.cells[a] - 1;
+            }
+            return true;
+        }
+
+    }
+
+}
@@ -0,0 +1,62 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+
+#include <ht_entity.h>
+#include <ht_debug.h>
+
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        static ComponentInfo s_components[MAX_COMPONENTS];
+        static std::atomic<uint32_t> s_componentCount(0);
+
+        uint32_t ComponentRegistry::Count()
+        {
+            return s_componentCount.load(std::memory_order_acquire);
+        }
+
+        const ComponentInfo& ComponentRegistry::Info(ComponentId id)
+        {
+            return s_components[id];
+        }
+
+        ComponentId ComponentRegistry::Register(uint32_t size, uint32_t alignment)
+        {
+            /*Called once per type from a function-local static, which C++11 serializes*/
+            ComponentId id = s_componentCount.fetch_add(1, std::memory_order_acq_rel);
+            assert(id < MAX_COMPONENTS && "Too many component types");
+            if (id >= MAX_COMPONENTS)
+            {
+                /*Sharing an id would memcpy this type into another type's column, so stop here*/
+#ifdef _DEBUG
+                Core::DebugPrintF("Component type limit of %u reached\n", MAX_COMPONENTS);
+#endif
+                std::abort();
+            }
+
+            s_components[id].size = size;
+            s_components[id].alignment = alignment;
+
+            return id;
+        }
+
+    }
+
+}
@@ -0,0 +1,89 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+
+#include <ht_entity_command_buffer.h>
+
+#include <cstring>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        EntityCommandBuffer::EntityCommandBuffer()
+        {
+            m_count = 0;
+            m_created = 0;
+        }
+
+        Entity EntityCommandBuffer::Create()
+        {
+            Entity placeholder;
+            placeholder.index = PLACEHOLDER_BIT | m_created++;
+            placeholder.generation = 0;
+
+            Write(CommandType::CREATE, placeholder, 0, nullptr, 0);
+
+            return placeholder;
+        }
+
+        void EntityCommandBuffer::Destroy(Entity entity)
+        {
+            Write(CommandType::DESTROY, entity, 0, nullptr, 0);
+        }
+
+        void EntityCommandBuffer::AddRaw(Entity entity, ComponentId id, const void* data, uint32_t size)
+        {
+            Write(CommandType::ADD, entity, id, data, size);
+        }
+
+        void EntityCommandBuffer::RemoveRaw(Entity entity, ComponentId id)
+        {
+            Write(CommandType::REMOVE, entity, id, nullptr, 0);
+        }
+
+        uint32_t EntityCommandBuffer::Count() const
+        {
+            return m_count;
+        }
+
+        void EntityCommandBuffer::Reset()
+        {
+            /*Keeps capacity so steady-state recording does not allocate*/
+            m_data.clear();
+            m_count = 0;
+            m_created = 0;
+        }
+
+        void EntityCommandBuffer::Write(CommandType type, Entity entity, ComponentId id, const void* data, uint32_t size)
+        {
+            CommandHeader header;
+            header.type = type;
+            header.component = id;
+            header.entity = entity;
+            header.size = size;
+            header.stride = static_cast<uint32_t>(sizeof(CommandHeader)) + ((size + 7) & ~7u);
+
+            size_t offset = m_data.size();
+            m_data.resize(offset + header.stride);
+            std::memcpy(&m_data[offset], &header, sizeof(header));
+            if (size > 0)
+                std::memcpy(&m_data[offset + sizeof(header)], data, size);
+
+            m_count++;
+        }
+
+    }
+
+}
@@ -0,0 +1,146 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_eventbus_singleton.h>
+
+#include <cstring>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        bool EventBus::Initialize(uint32_t capacity)
+        {
+            EventBus& _instance = EventBus::instance();
+
+            _instance.m_pending.reserve(capacity);
+            _instance.m_dispatched.reserve(capacity);
+            _instance.m_nextId = 1;
+
+            return _instance.m_posted.Initialize(capacity);
+        }
+
+        void EventBus::DeInitialize()
+        {
+            EventBus& _instance = EventBus::instance();
+
+            _instance.m_pending.clear();
+            _instance.m_dispatched.clear();
+            for (uint32_t i = 0; i < TYPE_COUNT; i++)
+                _instance.m_subscriptions[i].clear();
+            _instance.m_posted.DeInitialize();
+        }
+
+        uint32_t EventBus::Subscribe(EventType type, EventHandler handler, void* userData)
+        {
+            EventBus& _instance = EventBus::instance();
+
+            Subscription subscription;
+            subscription.id = _instance.m_nextId++;
+            subscription.handler = handler;
+            subscription.userData = userData;
+            _instance.m_subscriptions[static_cast<uint32_t>(type)].push_back(subscription);
+
+            return subscription.id;
+        }
+
+        void EventBus::Unsubscribe(uint32_t id)
+        {
+            EventBus& _instance = EventBus::instance();
+
+            for (uint32_t i = 0; i < TYPE_COUNT; i++)
+            {
+                std::vector<Subscription>& subscriptions = _instance.m_subscriptions[i];
+                for (size_t j = 0; j < subscriptions.size(); j++)
+                {
+                    if (subscriptions[j].id == id)
+                    {
+                        subscriptions.erase(subscriptions.begin() + j);
+                        return;
+                    }
+                }
+            }
+        }
+
+        void EventBus::Publish(const Event& event)
+        {
+            EventBus& _instance = EventBus::instance();
+
+            _instance.m_pending.push_back(event);
+        }
+
+        bool EventBus::Post(const Event& event)
+        {
+            EventBus& _instance = EventBus::instance();
+
+            return _instance.m_posted.Push(event);
+        }
+
+        void EventBus::Dispatch()
+        {
+            EventBus& _instance = EventBus::instance();
+
+            /*Pull in anything posted from other threads since the last dispatch*/
+            Event posted;
+            while (_instance.m_posted.Pop(posted))
+                _instance.m_pending.push_back(posted);
+
+            /*Counting sort by type so each type's events are contiguous, in arrival order*/
+            uint32_t* offsets = _instance.m_offsets;
+            std::memset(offsets, 0, sizeof(_instance.m_offsets));
+            for (size_t i = 0; i < _instance.m_pending.size(); i++)
+                offsets[static_cast<uint32_t>(_instance.m_pending[i].type) + 1]++;
+            for (uint32_t i = 0; i < TYPE_COUNT; i++)
+                offsets[i + 1] += offsets[i];
+
+            _instance.m_dispatched.resize(_instance.m_pending.size());
+            uint32_t cursor[TYPE_COUNT];
+            std::memcpy(cursor, offsets, sizeof(cursor));
+            for (size_t i = 0; i < _instance.m_pending.size(); i++)
+                _instance.m_dispatched[cursor[static_cast<uint32_t>(_instance.m_pending[i].type)]++] = _instance.m_pending[i];
+            _instance.m_pending.clear();
+
+            for (uint32_t type = 0; type < TYPE_COUNT; type++)
+            {
+                uint32_t count = offsets[type + 1] - offsets[type];
+                if (count == 0)
+                    continue;
+
+                const Event* batch = _instance.m_dispatched.data() + offsets[type];
+                const std::vector<Subscription>& subscriptions = _instance.m_subscriptions[type];
+                for (size_t i = 0; i < subscriptions.size(); i++)
+                    subscriptions[i].handler(batch, count, subscriptions[i].userData);
+            }
+        }
+
+        const Event* EventBus::PublishedEvents(uint32_t& count)
+        {
+            EventBus& _instance = EventBus::instance();
+
+            count = static_cast<uint32_t>(_instance.m_pending.size());
+
+            return _instance.m_pending.data();
+        }
+
+        const Event* EventBus::DispatchedEvents(uint32_t& count)
+        {
+            EventBus& _instance = EventBus::instance();
+
+            count = static_cast<uint32_t>(_instance.m_dispatched.size());
+
+            return _instance.m_dispatched.data();
+        }
+    }
+
+}
@@ -0,0 +1,159 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_frame_arena.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        LinearAllocator::LinearAllocator()
+        {
+            m_buffer = nullptr;
+            m_capacity = 0;
+            m_offset = 0;
+            m_failed = 0;
+            m_highWaterMark = 0;
+        }
+
+        LinearAllocator::~LinearAllocator()
+        {
+            DeInitialize();
+        }
+
+        bool LinearAllocator::Initialize(size_t capacity)
+        {
+            DeInitialize();
+
+            m_buffer = static_cast<uint8_t*>(std::malloc(capacity));
+            if (!m_buffer)
+                return false;
+
+            m_capacity = capacity;
+            m_offset = 0;
+            m_failed = 0;
+            m_highWaterMark = 0;
+
+            return true;
+        }
+
+        void LinearAllocator::DeInitialize()
+        {
+            std::free(m_buffer);
+            m_buffer = nullptr;
+            m_capacity = 0;
+            m_offset = 0;
+        }
+
+        void* LinearAllocator::Allocate(size_t size, size_t alignment)
+        {
+            uintptr_t base = reinterpret_cast<uintptr_t>(m_buffer);
+
+            size_t offset = m_offset.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                size_t aligned = ((base + offset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1)) - base;
+                size_t end = aligned + size;
+                if (end > m_capacity || end < aligned)
+                {
+                    m_failed.fetch_add(1, std::memory_order_relaxed);
+                    return nullptr;
+                }
+
+                if (m_offset.compare_exchange_weak(offset, end, std::memory_order_relaxed))
+                    return m_buffer + aligned;
+            }
+        }
+
+        void LinearAllocator::Reset()
+        {
+            m_highWaterMark = std::max(m_highWaterMark, m_offset.load(std::memory_order_relaxed));
+            m_offset.store(0, std::memory_order_relaxed);
+        }
+
+        size_t LinearAllocator::Used() const
+        {
+            return m_offset.load(std::memory_order_relaxed);
+        }
+
+        size_t LinearAllocator::Capacity() const
+        {
+            return m_capacity;
+        }
+
+        size_t LinearAllocator::HighWaterMark() const
+        {
+            return std::max(m_highWaterMark, m_offset.load(std::memory_order_relaxed));
+        }
+
+        size_t LinearAllocator::FailedAllocations() const
+        {
+            return m_failed.load(std::memory_order_relaxed);
+        }
+
+        FrameArena::FrameArena()
+        {
+            m_current = 0;
+        }
+
+        bool FrameArena::Initialize(size_t capacityPerFrame)
+        {
+            m_current = 0;
+
+            return m_allocators[0].Initialize(capacityPerFrame)
+                && m_allocators[1].Initialize(capacityPerFrame);
+        }
+
+        void FrameArena::DeInitialize()
+        {
+            m_allocators[0].DeInitialize();
+            m_allocators[1].DeInitialize();
+        }
+
+        void FrameArena::NextFrame()
+        {
+            m_current ^= 1;
+            m_allocators[m_current].Reset();
+        }
+
+        void* FrameArena::Allocate(size_t size, size_t alignment)
+        {
+            return m_allocators[m_current].Allocate(size, alignment);
+        }
+
+        LinearAllocator& FrameArena::Current()
+        {
+            return m_allocators[m_current];
+        }
+
+        size_t FrameArena::HighWaterMark() const
+        {
+            return std::max(m_allocators[0].HighWaterMark(), m_allocators[1].HighWaterMark());
+        }
+
+        size_t FrameArena::Capacity() const
+        {
+            return m_allocators[0].Capacity();
+        }
+
+        size_t FrameArena::FailedAllocations() const
+        {
+            return m_allocators[0].FailedAllocations() + m_allocators[1].FailedAllocations();
+        }
+    }
+
+}
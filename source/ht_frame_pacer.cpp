@@ -0,0 +1,195 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_frame_pacer.h>
+#include <ht_debug.h>
+#include <ht_time_singleton.h>
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        /*Upper bounds of the pacing error buckets in nanoseconds; the last one is open*/
+        static const uint64_t s_bucketBounds[FramePacer::HISTOGRAM_BUCKETS] =
+        {
+            10000,
+            25000,
+            50000,
+            100000,
+            250000,
+            500000,
+            1000000,
+            UINT64_MAX
+        };
+
+        FramePacer::FramePacer()
+        {
+            m_period = 0;
+            m_spin = 0;
+            m_mode = PacingMode::FIXED;
+            m_lastPresent = 0;
+            m_presentInterval = 0;
+            Reset();
+        }
+
+        void FramePacer::Configure(uint64_t periodTicks, uint64_t spinTicks, PacingMode mode)
+        {
+            m_period = periodTicks;
+            m_spin = spinTicks;
+            m_mode = mode;
+            m_deadline = 0;
+            m_lastWake = 0;
+            m_latency = 0;
+        }
+
+        void FramePacer::Reset()
+        {
+            m_deadline = 0;
+            m_lastWake = 0;
+            m_latency = 0;
+            for (uint32_t i = 0; i < HISTOGRAM_BUCKETS; i++)
+                m_histogram[i] = 0;
+            m_samples = 0;
+            m_errorSum = 0;
+            m_errorMax = 0;
+        }
+
+        bool FramePacer::Enabled() const
+        {
+            return m_period > 0;
+        }
+
+        void FramePacer::Wait()
+        {
+            if (m_period == 0)
+                return;
+
+            uint64_t now = Time::Ticks();
+            uint64_t period = m_period;
+
+            if (m_mode == PacingMode::PRESENT)
+            {
+                /*
+                * Keep the period fixed and only take the phase from the
+                * display: aim the next present one period after the last
+                * one, less the usual wake-to-present latency. A present that
+                * predates the last wake (threaded rendering still behind)
+                * leaves the fixed schedule alone.
+                */
+                uint64_t lastPresent = m_lastPresent.load(std::memory_order_relaxed);
+                if (m_lastWake != 0 && lastPresent > m_lastWake)
+                {
+                    uint64_t latency = lastPresent - m_lastWake;
+                    m_latency = (m_latency == 0) ? latency : m_latency - m_latency / 8 + latency / 8;
+                    if (m_latency < period)
+                        m_deadline = lastPresent + period - m_latency;
+                }
+            }
+
+            /*First frame, or we fell more than a whole period behind: restart the schedule*/
+            if (m_deadline == 0 || now > m_deadline + period)
+                m_deadline = now + period;
+
+            if (m_deadline > now)
+            {
+                uint64_t remaining = m_deadline - now;
+                if (remaining > m_spin)
+                    std::this_thread::sleep_for(std::chrono::nanoseconds(remaining - m_spin));
+
+                while ((now = Time::Ticks()) < m_deadline)
+                    std::this_thread::yield();
+            }
+
+            uint64_t error = (now > m_deadline) ? now - m_deadline : 0;
+            uint32_t bucket = 0;
+            while (error >= s_bucketBounds[bucket])
+                bucket++;
+            m_histogram[bucket]++;
+            m_samples++;
+            m_errorSum += error;
+            if (error > m_errorMax)
+                m_errorMax = error;
+
+            m_lastWake = now;
+            m_deadline += period;
+        }
+
+        void FramePacer::RecordPresent(uint64_t now)
+        {
+            uint64_t last = m_lastPresent.exchange(now, std::memory_order_relaxed);
+            if (last == 0 || now <= last)
+                return;
+
+            /*Exponential moving average, 1/8 weight per sample*/
+            uint64_t interval = now - last;
+            uint64_t average = m_presentInterval.load(std::memory_order_relaxed);
+            average = (average == 0) ? interval : average - average / 8 + interval / 8;
+            m_presentInterval.store(average, std::memory_order_relaxed);
+        }
+
+        uint64_t FramePacer::PresentInterval() const
+        {
+            return m_presentInterval.load(std::memory_order_relaxed);
+        }
+
+        uint64_t FramePacer::HistogramCount(uint32_t bucket) const
+        {
+            return (bucket < HISTOGRAM_BUCKETS) ? m_histogram[bucket] : 0;
+        }
+
+        uint64_t FramePacer::HistogramUpperBound(uint32_t bucket) const
+        {
+            return (bucket < HISTOGRAM_BUCKETS) ? s_bucketBounds[bucket] : UINT64_MAX;
+        }
+
+        uint64_t FramePacer::MaxError() const
+        {
+            return m_errorMax;
+        }
+
+        double FramePacer::MeanError() const
+        {
+            return (m_samples > 0) ? static_cast<double>(m_errorSum) / m_samples : 0.0;
+        }
+
+        void FramePacer::Dump() const
+        {
+            if (m_samples == 0)
+                return;
+
+            Core::DebugPrintF("Frame pacing error over %llu frames (us): mean %.1f  max %.1f\n",
+                static_cast<unsigned long long>(m_samples), MeanError() / 1.0e3, m_errorMax / 1.0e3);
+
+            uint64_t lower = 0;
+            for (uint32_t i = 0; i < HISTOGRAM_BUCKETS; i++)
+            {
+                if (s_bucketBounds[i] == UINT64_MAX)
+                    Core::DebugPrintF("    >= %6llu      %llu\n",
+                        static_cast<unsigned long long>(lower / 1000),
+                        static_cast<unsigned long long>(m_histogram[i]));
+                else
+                    Core::DebugPrintF("    %6llu-%-6llu %llu\n",
+                        static_cast<unsigned long long>(lower / 1000),
+                        static_cast<unsigned long long>(s_bucketBounds[i] / 1000),
+                        static_cast<unsigned long long>(m_histogram[i]));
+                lower = s_bucketBounds[i];
+            }
+        }
+    }
+
+}
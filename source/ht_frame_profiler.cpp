@@ -0,0 +1,144 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_frame_profiler.h>
+#include <ht_debug.h>
+#include <ht_time_singleton.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        static const char* s_phaseNames[FrameProfiler::PHASE_COUNT] =
+        {
+            "tick",
+            "events",
+            "update",
+            "xform",
+            "record",
+            "submit",
+            "swap",
+            "pace"
+        };
+
+        FrameProfiler::FrameProfiler()
+        {
+            Reset();
+        }
+
+        void FrameProfiler::Reset()
+        {
+            std::memset(&m_current, 0, sizeof(m_current));
+            m_frameStart = 0;
+            m_head = 0;
+            m_count = 0;
+        }
+
+        void FrameProfiler::BeginFrame(uint64_t now)
+        {
+            /*Commit the frame that just ended, unless this is the first one*/
+            if (m_frameStart != 0)
+            {
+                m_current.total = now - m_frameStart;
+                m_history[m_head] = m_current;
+                m_head = (m_head + 1) % HISTORY_SIZE;
+                if (m_count < HISTORY_SIZE)
+                    m_count++;
+            }
+
+            std::memset(&m_current, 0, sizeof(m_current));
+            m_frameStart = now;
+        }
+
+        void FrameProfiler::RecordPhase(FramePhase phase, uint64_t nanoseconds)
+        {
+            m_current.phases[static_cast<uint32_t>(phase)] += nanoseconds;
+        }
+
+        uint32_t FrameProfiler::SampleCount() const
+        {
+            return m_count;
+        }
+
+        uint64_t FrameProfiler::FrameTimePercentile(float percentile) const
+        {
+            return Percentile(-1, percentile);
+        }
+
+        uint64_t FrameProfiler::PhaseTimePercentile(FramePhase phase, float percentile) const
+        {
+            return Percentile(static_cast<int>(phase), percentile);
+        }
+
+        uint64_t FrameProfiler::MaxFrameTime() const
+        {
+            return Percentile(-1, 100.0f);
+        }
+
+        uint64_t FrameProfiler::Percentile(int phase, float percentile) const
+        {
+            if (m_count == 0)
+                return 0;
+
+            for (uint32_t i = 0; i < m_count; i++)
+                m_scratch[i] = (phase < 0) ? m_history[i].total : m_history[i].phases[phase];
+
+            /*Nearest-rank percentile*/
+            float clamped = std::min(std::max(percentile, 0.0f), 100.0f);
+            uint32_t rank = static_cast<uint32_t>(std::ceil(clamped / 100.0f * m_count));
+            uint32_t index = (rank == 0) ? 0 : rank - 1;
+
+            std::nth_element(m_scratch, m_scratch + index, m_scratch + m_count);
+
+            return m_scratch[index];
+        }
+
+        void FrameProfiler::Dump() const
+        {
+            Core::DebugPrintF("Frame times over last %u frames (ms): p50 %.3f  p95 %.3f  p99 %.3f  max %.3f\n",
+                m_count,
+                FrameTimePercentile(50.0f) / 1.0e6,
+                FrameTimePercentile(95.0f) / 1.0e6,
+                FrameTimePercentile(99.0f) / 1.0e6,
+                MaxFrameTime() / 1.0e6);
+
+            for (uint32_t i = 0; i < PHASE_COUNT; i++)
+            {
+                FramePhase phase = static_cast<FramePhase>(i);
+                Core::DebugPrintF("    %-8s p50 %.3f  p95 %.3f  p99 %.3f  max %.3f\n",
+                    s_phaseNames[i],
+                    PhaseTimePercentile(phase, 50.0f) / 1.0e6,
+                    PhaseTimePercentile(phase, 95.0f) / 1.0e6,
+                    PhaseTimePercentile(phase, 99.0f) / 1.0e6,
+                    PhaseTimePercentile(phase, 100.0f) / 1.0e6);
+            }
+        }
+
+        ScopedFramePhase::ScopedFramePhase(FramePhase phase)
+        {
+            m_phase = phase;
+            m_start = Time::Ticks();
+        }
+
+        ScopedFramePhase::~ScopedFramePhase()
+        {
+            Time::RecordPhase(m_phase, Time::Ticks() - m_start);
+        }
+    }
+
+}
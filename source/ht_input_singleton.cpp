@@ -0,0 +1,392 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_input_singleton.h>
+#include <ht_eventbus_singleton.h>
+
+#include <cstring>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        const int32_t Input::FREE_SLOT;
+
+        static void ClearState(InputState& state)
+        {
+            state.keys.reset();
+            state.keysPressed.reset();
+            state.keysReleased.reset();
+            state.mouseButtons.reset();
+            state.mousePressed.reset();
+            state.mouseReleased.reset();
+            for (uint32_t i = 0; i < InputState::CONTROLLER_COUNT; i++)
+            {
+                state.controllerButtons[i].reset();
+                state.controllerPressed[i].reset();
+                state.controllerReleased[i].reset();
+            }
+            std::memset(state.controllerAxes, 0, sizeof(state.controllerAxes));
+            state.mouseX = 0;
+            state.mouseY = 0;
+            state.mouseDeltaX = 0;
+            state.mouseDeltaY = 0;
+            state.wheelX = 0;
+            state.wheelY = 0;
+        }
+
+        Input::Input()
+        {
+            ClearState(m_pending);
+            ClearState(m_current);
+            ClearState(m_previous);
+            for (uint32_t i = 0; i < InputState::CONTROLLER_COUNT; i++)
+                m_controllerIds[i] = FREE_SLOT;
+            m_subscriptionCount = 0;
+        }
+
+        bool Input::Initialize()
+        {
+            Input& _instance = Input::instance();
+
+            static const EventType keyEvents[] = { EventType::KEY };
+            static const EventType mouseEvents[] = { EventType::MOUSE_MOTION, EventType::MOUSE_BUTTON, EventType::MOUSE_WHEEL };
+            static const EventType controllerEvents[] = { EventType::CONTROLLER_ADDED, EventType::CONTROLLER_REMOVED,
+                                                          EventType::CONTROLLER_BUTTON, EventType::CONTROLLER_AXIS };
+
+            ClearState(_instance.m_pending);
+            ClearState(_instance.m_current);
+            ClearState(_instance.m_previous);
+            for (uint32_t i = 0; i < InputState::CONTROLLER_COUNT; i++)
+                _instance.m_controllerIds[i] = FREE_SLOT;
+
+            _instance.m_subscriptionCount = 0;
+            for (EventType type : keyEvents)
+                _instance.m_subscriptions[_instance.m_subscriptionCount++] = EventBus::Subscribe(type, &Input::OnKey, nullptr);
+            for (EventType type : mouseEvents)
+                _instance.m_subscriptions[_instance.m_subscriptionCount++] = EventBus::Subscribe(type, &Input::OnMouse, nullptr);
+            for (EventType type : controllerEvents)
+                _instance.m_subscriptions[_instance.m_subscriptionCount++] = EventBus::Subscribe(type, &Input::OnController, nullptr);
+
+            return true;
+        }
+
+        void Input::DeInitialize()
+        {
+            Input& _instance = Input::instance();
+
+            for (uint32_t i = 0; i < _instance.m_subscriptionCount; i++)
+                EventBus::Unsubscribe(_instance.m_subscriptions[i]);
+            _instance.m_subscriptionCount = 0;
+        }
+
+        void Input::Update()
+        {
+            Input& _instance = Input::instance();
+
+            _instance.m_previous = _instance.m_current;
+            _instance.m_current = _instance.m_pending;
+
+            /*Edges and relative motion belong to the frame that saw them*/
+            InputState& pending = _instance.m_pending;
+            pending.keysPressed.reset();
+            pending.keysReleased.reset();
+            pending.mousePressed.reset();
+            pending.mouseReleased.reset();
+            for (uint32_t i = 0; i < InputState::CONTROLLER_COUNT; i++)
+            {
+                pending.controllerPressed[i].reset();
+                pending.controllerReleased[i].reset();
+            }
+            pending.mouseDeltaX = 0;
+            pending.mouseDeltaY = 0;
+            pending.wheelX = 0;
+            pending.wheelY = 0;
+        }
+
+        void Input::OnKey(const Event* events, uint32_t count, void*)
+        {
+            Input& _instance = Input::instance();
+
+            InputState& pending = _instance.m_pending;
+
+            for (uint32_t i = 0; i < count; i++)
+            {
+                const Event& event = events[i];
+                uint32_t code = event.key.scancode;
+                if (code >= InputState::KEY_COUNT)
+                    continue;
+
+                if (event.key.down)
+                {
+                    if (!event.key.repeat)
+                        pending.keysPressed.set(code);
+                    pending.keys.set(code);
+                }
+                else
+                {
+                    pending.keysReleased.set(code);
+                    pending.keys.reset(code);
+                }
+            }
+        }
+
+        void Input::OnMouse(const Event* events, uint32_t count, void*)
+        {
+            Input& _instance = Input::instance();
+
+            InputState& pending = _instance.m_pending;
+
+            for (uint32_t i = 0; i < count; i++)
+            {
+                const Event& event = events[i];
+                switch (event.type)
+                {
+                case EventType::MOUSE_MOTION:
+                    pending.mouseX = event.mouse.x;
+                    pending.mouseY = event.mouse.y;
+                    pending.mouseDeltaX += event.mouse.dx;
+                    pending.mouseDeltaY += event.mouse.dy;
+                    break;
+
+                case EventType::MOUSE_BUTTON:
+                    if (event.mouse.button >= InputState::MOUSE_BUTTON_COUNT)
+                        break;
+
+                    if (event.mouse.down)
+                    {
+                        pending.mouseButtons.set(event.mouse.button);
+                        pending.mousePressed.set(event.mouse.button);
+                    }
+                    else
+                    {
+                        pending.mouseButtons.reset(event.mouse.button);
+                        pending.mouseReleased.set(event.mouse.button);
+                    }
+                    break;
+
+                case EventType::MOUSE_WHEEL:
+                    pending.wheelX += event.mouse.dx;
+                    pending.wheelY += event.mouse.dy;
+                    break;
+
+                default:
+                    break;
+                }
+            }
+        }
+
+        void Input::OnController(const Event* events, uint32_t count, void*)
+        {
+            Input& _instance = Input::instance();
+
+            InputState& pending = _instance.m_pending;
+
+            for (uint32_t i = 0; i < count; i++)
+            {
+                const Event& event = events[i];
+
+                /*Ids are joystick instance ids; a controller keeps its slot until removed*/
+                uint32_t slot = ControllerSlot(event.controller.id, event.type != EventType::CONTROLLER_REMOVED);
+                if (slot == InputState::CONTROLLER_COUNT)
+                    continue;
+
+                uint32_t control = event.controller.control;
+
+                switch (event.type)
+                {
+                case EventType::CONTROLLER_REMOVED:
+                    pending.controllerReleased[slot] |= pending.controllerButtons[slot];
+                    pending.controllerButtons[slot].reset();
+                    std::memset(pending.controllerAxes[slot], 0, sizeof(pending.controllerAxes[slot]));
+                    _instance.m_controllerIds[slot] = FREE_SLOT;
+                    break;
+
+                case EventType::CONTROLLER_BUTTON:
+                    if (control >= InputState::CONTROLLER_BUTTON_COUNT)
+                        break;
+
+                    if (event.controller.value)
+                    {
+                        pending.controllerButtons[slot].set(control);
+                        pending.controllerPressed[slot].set(control);
+                    }
+                    else
+                    {
+                        pending.controllerButtons[slot].reset(control);
+                        pending.controllerReleased[slot].set(control);
+                    }
+                    break;
+
+                case EventType::CONTROLLER_AXIS:
+                    if (control < InputState::CONTROLLER_AXIS_COUNT)
+                        pending.controllerAxes[slot][control] = event.controller.value;
+                    break;
+
+                default:
+                    break;
+                }
+            }
+        }
+
+        uint32_t Input::ControllerSlot(int32_t id, bool claim)
+        {
+            Input& _instance = Input::instance();
+
+            uint32_t free = InputState::CONTROLLER_COUNT;
+            for (uint32_t i = 0; i < InputState::CONTROLLER_COUNT; i++)
+            {
+                if (_instance.m_controllerIds[i] == id)
+                    return i;
+                if (_instance.m_controllerIds[i] == FREE_SLOT && free == InputState::CONTROLLER_COUNT)
+                    free = i;
+            }
+
+            /*Past CONTROLLER_COUNT controllers, the extra ones are ignored*/
+            if (claim && free != InputState::CONTROLLER_COUNT)
+                _instance.m_controllerIds[free] = id;
+
+            return claim ? free : InputState::CONTROLLER_COUNT;
+        }
+
+        bool Input::KeyHeld(Key key)
+        {
+            Input& _instance = Input::instance();
+
+            return _instance.m_current.keys.test(static_cast<uint32_t>(key));
+        }
+
+        bool Input::KeyPressed(Key key)
+        {
+            Input& _instance = Input::instance();
+
+            return _instance.m_current.keysPressed.test(static_cast<uint32_t>(key));
+        }
+
+        bool Input::KeyReleased(Key key)
+        {
+            Input& _instance = Input::instance();
+
+            return _instance.m_current.keysReleased.test(static_cast<uint32_t>(key));
+        }
+
+        bool Input::MouseButtonHeld(MouseButton button)
+        {
+            Input& _instance = Input::instance();
+
+            return _instance.m_current.mouseButtons.test(static_cast<uint32_t>(button));
+        }
+
+        bool Input::MouseButtonPressed(MouseButton button)
+        {
+            Input& _instance = Input::instance();
+
+            return _instance.m_current.mousePressed.test(static_cast<uint32_t>(button));
+        }
+
+        bool Input::MouseButtonReleased(MouseButton button)
+        {
+            Input& _instance = Input::instance();
+
+            return _instance.m_current.mouseReleased.test(static_cast<uint32_t>(button));
+        }
+
+        void Input::MousePosition(int32_t& x, int32_t& y)
+        {
+            Input& _instance = Input::instance();
+
+            const InputState& state = _instance.m_current;
+
+            x = state.mouseX;
+            y = state.mouseY;
+        }
+
+        void Input::MouseDelta(int32_t& dx, int32_t& dy)
+        {
+            Input& _instance = Input::instance();
+
+            const InputState& state = _instance.m_current;
+
+            dx = state.mouseDeltaX;
+            dy = state.mouseDeltaY;
+        }
+
+        void Input::MouseWheel(int32_t& x, int32_t& y)
+        {
+            Input& _instance = Input::instance();
+
+            const InputState& state = _instance.m_current;
+
+            x = state.wheelX;
+            y = state.wheelY;
+        }
+
+        bool Input::ControllerButtonHeld(uint32_t controller, ControllerButton button)
+        {
+            if (controller >= InputState::CONTROLLER_COUNT)
+                return false;
+
+            Input& _instance = Input::instance();
+
+            return _instance.m_current.controllerButtons[controller].test(static_cast<uint32_t>(button));
+        }
+
+        bool Input::ControllerButtonPressed(uint32_t controller, ControllerButton button)
+        {
+            if (controller >= InputState::CONTROLLER_COUNT)
+                return false;
+
+            Input& _instance = Input::instance();
+
+            return _instance.m_current.controllerPressed[controller].test(static_cast<uint32_t>(button));
+        }
+
+        bool Input::ControllerButtonReleased(uint32_t controller, ControllerButton button)
+        {
+            if (controller >= InputState::CONTROLLER_COUNT)
+                return false;
+
+            Input& _instance = Input::instance();
+
+            return _instance.m_current.controllerReleased[controller].test(static_cast<uint32_t>(button));
+        }
+
+        float Input::ControllerAxisValue(uint32_t controller, ControllerAxis axis)
+        {
+            if (controller >= InputState::CONTROLLER_COUNT)
+                return 0.0f;
+
+            Input& _instance = Input::instance();
+
+            int16_t value = _instance.m_current.controllerAxes[controller][static_cast<uint32_t>(axis)];
+
+            return (value < 0) ? value / 32768.0f : value / 32767.0f;
+        }
+
+        const InputState& Input::Current()
+        {
+            Input& _instance = Input::instance();
+
+            return _instance.m_current;
+        }
+
+        const InputState& Input::Previous()
+        {
+            Input& _instance = Input::instance();
+
+            return _instance.m_previous;
+        }
+    }
+
+}
@@ -0,0 +1,361 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_jobsystem.h>
+#include <ht_debug.h>
+
+#include <algorithm>
+#include <exception>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        static thread_local uint32_t s_threadIndex = 0;
+
+        struct QueuedJob
+        {
+            Job         job;
+            JobCounter* counter;
+        };
+
+        /*
+        * Bounded deque guarded by a mutex. Jobs are tiny and pushes are rare
+        * compared to the work they carry, so an uncontended lock is cheap.
+        */
+        class JobQueue
+        {
+        public:
+            static const uint32_t CAPACITY = 4096;
+
+            JobQueue()
+            {
+                m_head = 0;
+                m_count = 0;
+            }
+
+            bool PushBack(const QueuedJob& job)
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                if (m_count == CAPACITY)
+                    return false;
+
+                m_jobs[(m_head + m_count) % CAPACITY] = job;
+                m_count++;
+                return true;
+            }
+
+            bool PushFront(const QueuedJob& job)
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                if (m_count == CAPACITY)
+                    return false;
+
+                m_head = (m_head + CAPACITY - 1) % CAPACITY;
+                m_jobs[m_head] = job;
+                m_count++;
+                return true;
+            }
+
+            bool PopBack(QueuedJob& job)
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                if (m_count == 0)
+                    return false;
+
+                m_count--;
+                job = m_jobs[(m_head + m_count) % CAPACITY];
+                return true;
+            }
+
+            bool PopFront(QueuedJob& job)
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                if (m_count == 0)
+                    return false;
+
+                job = m_jobs[m_head];
+                m_head = (m_head + 1) % CAPACITY;
+                m_count--;
+                return true;
+            }
+
+        private:
+            std::mutex m_lock;
+            QueuedJob  m_jobs[CAPACITY];
+            uint32_t   m_head;
+            uint32_t   m_count;
+        };
+
+        JobCounter::JobCounter()
+        {
+            m_value = 0;
+        }
+
+        int32_t JobCounter::Value() const
+        {
+            return m_value.load(std::memory_order_acquire);
+        }
+
+        JobSystem::JobSystem()
+        {
+            m_queues = nullptr;
+            m_queueCount = 0;
+            m_pending = 0;
+            m_sleeping = 0;
+            m_shutdown = false;
+        }
+
+        const uint32_t JobSystem::MAX_WORKERS;
+
+        bool JobSystem::Initialize(int workerCount)
+        {
+            JobSystem& _instance = JobSystem::instance();
+
+            /*A negative count means one worker per hardware thread besides the main thread*/
+            if (workerCount < 0)
+            {
+                int hardware = static_cast<int>(std::thread::hardware_concurrency());
+                workerCount = std::max(hardware - 1, 0);
+            }
+            workerCount = std::min(workerCount, static_cast<int>(MAX_WORKERS));
+
+            _instance.m_pending = 0;
+            _instance.m_sleeping = 0;
+            _instance.m_shutdown = false;
+
+            s_threadIndex = 0;
+            try
+            {
+                _instance.m_queueCount = static_cast<uint32_t>(workerCount) + 1;
+                _instance.m_queues = new JobQueue[_instance.m_queueCount];
+                for (uint32_t i = 1; i < _instance.m_queueCount; i++)
+                    _instance.m_workers.push_back(std::thread(&JobSystem::WorkerMain, i));
+            }
+            catch (const std::exception& e)
+            {
+                /*Out of threads or memory: stop whatever did start and leave nothing running*/
+#ifdef _DEBUG
+                Core::DebugPrintF("Job system failed to start %d worker thread(s): %s\n", workerCount, e.what());
+#else
+                (void)e;
+#endif
+                DeInitialize();
+                return false;
+            }
+
+#ifdef _DEBUG
+            Core::DebugPrintF("Job system started with %d worker thread(s)\n", workerCount);
+#endif
+
+            return true;
+        }
+
+        void JobSystem::DeInitialize()
+        {
+            JobSystem& _instance = JobSystem::instance();
+
+            {
+                std::lock_guard<std::mutex> lock(_instance.m_sleepMutex);
+                _instance.m_shutdown = true;
+            }
+            _instance.m_wake.notify_all();
+
+            for (size_t i = 0; i < _instance.m_workers.size(); i++)
+                _instance.m_workers[i].join();
+            _instance.m_workers.clear();
+
+            delete[] _instance.m_queues;
+            _instance.m_queues = nullptr;
+            _instance.m_queueCount = 0;
+        }
+
+        void JobSystem::Run(const Job* jobs, uint32_t count, JobCounter* counter)
+        {
+            JobSystem& _instance = JobSystem::instance();
+
+            uint32_t index = s_threadIndex;
+
+            if (counter)
+                counter->m_value.fetch_add(static_cast<int32_t>(count), std::memory_order_relaxed);
+
+            for (uint32_t i = 0; i < count; i++)
+            {
+                QueuedJob queued;
+                queued.job = jobs[i];
+                queued.counter = counter;
+
+                _instance.m_pending.fetch_add(1);
+
+                /*Queue full: do the work right here rather than fail*/
+                if (!_instance.m_queues[index].PushBack(queued))
+                    Execute(index, queued);
+            }
+
+            if (_instance.m_sleeping.load() > 0)
+            {
+                std::lock_guard<std::mutex> lock(_instance.m_sleepMutex);
+                _instance.m_wake.notify_all();
+            }
+        }
+
+        void JobSystem::Run(JobFunction function, void* data, JobCounter* counter)
+        {
+            Job job;
+            job.function = function;
+            job.data = data;
+            job.dependency = nullptr;
+
+            Run(&job, 1, counter);
+        }
+
+        void JobSystem::Wait(JobCounter* counter)
+        {
+            uint32_t index = s_threadIndex;
+
+            while (counter->m_value.load(std::memory_order_acquire) > 0)
+            {
+                QueuedJob job;
+                if (FindJob(index, job))
+                    Execute(index, job);
+                else
+                    std::this_thread::yield();
+            }
+        }
+
+        struct ParallelForBatch
+        {
+            ParallelForFunction function;
+            void*               data;
+            uint32_t            begin;
+            uint32_t            end;
+        };
+
+        static void RunParallelForBatch(void* data)
+        {
+            ParallelForBatch* batch = static_cast<ParallelForBatch*>(data);
+            batch->function(batch->begin, batch->end, batch->data);
+        }
+
+        void JobSystem::ParallelFor(uint32_t count, uint32_t batchSize, ParallelForFunction function, void* data)
+        {
+            static const uint32_t MAX_BATCHES = 256;
+
+            if (count == 0)
+                return;
+
+            /*Widen batches rather than allocate when the range is large*/
+            batchSize = std::max(batchSize, 1u);
+            batchSize = std::max(batchSize, (count + MAX_BATCHES - 1) / MAX_BATCHES);
+            uint32_t batchCount = (count + batchSize - 1) / batchSize;
+
+            ParallelForBatch batches[MAX_BATCHES];
+            Job jobs[MAX_BATCHES];
+            for (uint32_t i = 0; i < batchCount; i++)
+            {
+                batches[i].function = function;
+                batches[i].data = data;
+                batches[i].begin = i * batchSize;
+                batches[i].end = std::min(count, batches[i].begin + batchSize);
+
+                jobs[i].function = &RunParallelForBatch;
+                jobs[i].data = &batches[i];
+                jobs[i].dependency = nullptr;
+            }
+
+            JobCounter counter;
+            Run(jobs, batchCount, &counter);
+            Wait(&counter);
+        }
+
+        uint32_t JobSystem::ThreadCount()
+        {
+            JobSystem& _instance = JobSystem::instance();
+
+            return _instance.m_queueCount;
+        }
+
+        uint32_t JobSystem::ThreadIndex()
+        {
+            return s_threadIndex;
+        }
+
+        void JobSystem::WorkerMain(uint32_t index)
+        {
+            JobSystem& _instance = JobSystem::instance();
+
+            s_threadIndex = index;
+
+            while (!_instance.m_shutdown.load())
+            {
+                QueuedJob job;
+                if (FindJob(index, job))
+                {
+                    Execute(index, job);
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock(_instance.m_sleepMutex);
+                _instance.m_sleeping.fetch_add(1);
+                _instance.m_wake.wait(lock, [&_instance]() {
+                    return _instance.m_shutdown.load() || _instance.m_pending.load() > 0;
+                });
+                _instance.m_sleeping.fetch_sub(1);
+            }
+        }
+
+        bool JobSystem::FindJob(uint32_t index, QueuedJob& job)
+        {
+            JobSystem& _instance = JobSystem::instance();
+
+            if (_instance.m_queues[index].PopBack(job))
+                return true;
+
+            for (uint32_t i = 1; i < _instance.m_queueCount; i++)
+            {
+                uint32_t victim = (index + i) % _instance.m_queueCount;
+                if (_instance.m_queues[victim].PopFront(job))
+                    return true;
+            }
+
+            return false;
+        }
+
+        void JobSystem::Execute(uint32_t index, const QueuedJob& job)
+        {
+            JobSystem& _instance = JobSystem::instance();
+
+            /*Dependency not finished yet: park the job at the steal end and move on*/
+            JobCounter* dependency = job.job.dependency;
+            if (dependency && dependency->Value() > 0)
+            {
+                if (_instance.m_queues[index].PushFront(job))
+                {
+                    std::this_thread::yield();
+                    return;
+                }
+
+                Wait(dependency);
+            }
+
+            _instance.m_pending.fetch_sub(1);
+
+            job.job.function(job.job.data);
+
+            if (job.counter)
+                job.counter->m_value.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+}
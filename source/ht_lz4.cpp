@@ -0,0 +1,227 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+
+#include <ht_lz4.h>
+
+#include <cstring>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        static const size_t MIN_MATCH = 4;
+        /*The format requires the last match to start 12 bytes and end 5 bytes before the input ends*/
+        static const size_t MATCH_FIND_LIMIT = 12;
+        static const size_t LAST_LITERALS = 5;
+        static const size_t MAX_OFFSET = 65535;
+        static const uint32_t HASH_BITS = 12;
+
+        static inline uint32_t Read32(const uint8_t* p)
+        {
+            uint32_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        static inline uint32_t Hash(uint32_t sequence)
+        {
+            return (sequence * 2654435761u) >> (32 - HASH_BITS);
+        }
+
+        /*Lengths of 15 or more continue in bytes of 255 and a final remainder*/
+        static inline bool WriteLength(size_t length, uint8_t*& op, const uint8_t* oend)
+        {
+            while (length >= 255)
+            {
+                if (op >= oend)
+                    return false;
+                *op++ = 255;
+                length -= 255;
+            }
+            if (op >= oend)
+                return false;
+            *op++ = static_cast<uint8_t>(length);
+            return true;
+        }
+
+        static inline bool ReadLength(size_t& length, const uint8_t*& ip, const uint8_t* iend)
+        {
+            uint8_t byte;
+            do
+            {
+                if (ip >= iend)
+                    return false;
+                byte = *ip++;
+                length += byte;
+            } while (byte == 255);
+            return true;
+        }
+
+        static bool WriteSequence(const uint8_t* literals, size_t literalLength, size_t offset, size_t matchLength,
+                                  uint8_t*& op, const uint8_t* oend)
+        {
+            if (op >= oend)
+                return false;
+
+            uint8_t* token = op++;
+            *token = static_cast<uint8_t>((literalLength >= 15 ? 15 : literalLength) << 4);
+            if (literalLength >= 15 && !WriteLength(literalLength - 15, op, oend))
+                return false;
+
+            if (static_cast<size_t>(oend - op) < literalLength)
+                return false;
+            if (literalLength > 0)
+                std::memcpy(op, literals, literalLength);
+            op += literalLength;
+
+            /*The final sequence is literals only*/
+            if (matchLength == 0)
+                return true;
+
+            if (oend - op < 2)
+                return false;
+            *op++ = static_cast<uint8_t>(offset & 0xFF);
+            *op++ = static_cast<uint8_t>(offset >> 8);
+
+            matchLength -= MIN_MATCH;
+            *token |= static_cast<uint8_t>(matchLength >= 15 ? 15 : matchLength);
+            if (matchLength >= 15 && !WriteLength(matchLength - 15, op, oend))
+                return false;
+
+            return true;
+        }
+
+        size_t LZ4::CompressBound(size_t size)
+        {
+            return size + size / 255 + 16;
+        }
+
+        size_t LZ4::Compress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity)
+        {
+            uint8_t* op = dst;
+            const uint8_t* oend = dst + dstCapacity;
+            size_t anchor = 0;
+
+            if (srcSize > MATCH_FIND_LIMIT)
+            {
+                /*Positions are stored plus one so zero means empty*/
+                uint32_t table[1 << HASH_BITS];
+                std::memset(table, 0, sizeof(table));
+
+                size_t limit = srcSize - MATCH_FIND_LIMIT;
+                size_t matchLimit = srcSize - LAST_LITERALS;
+                size_t ip = 0;
+                while (ip < limit)
+                {
+                    uint32_t sequence = Read32(src + ip);
+                    uint32_t h = Hash(sequence);
+                    size_t candidate = table[h];
+                    table[h] = static_cast<uint32_t>(ip + 1);
+
+                    if (candidate == 0 || ip - (candidate - 1) > MAX_OFFSET || Read32(src + candidate - 1) != sequence)
+                    {
+                        ip++;
+                        continue;
+                    }
+
+                    size_t match = candidate - 1;
+                    size_t length = MIN_MATCH;
+                    while (ip + length < matchLimit && src[match + length] == src[ip + length])
+                        length++;
+
+                    if (!WriteSequence(src + anchor, ip - anchor, ip - match, length, op, oend))
+                        return 0;
+
+                    ip += length;
+                    anchor = ip;
+                }
+            }
+
+            if (!WriteSequence(src + anchor, srcSize - anchor, 0, 0, op, oend))
+                return 0;
+
+            return static_cast<size_t>(op - dst);
+        }
+
+        size_t LZ4::Decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity)
+        {
+            const uint8_t* ip = src;
+            const uint8_t* iend = src + srcSize;
+            uint8_t* op = dst;
+            uint8_t* oend = dst + dstCapacity;
+
+            while (ip < iend)
+            {
+                uint8_t token = *ip++;
+
+                size_t literalLength = token >> 4;
+                if (literalLength == 15 && !ReadLength(literalLength, ip, iend))
+                    return 0;
+                if (literalLength > static_cast<size_t>(iend - ip) || literalLength > static_cast<size_t>(oend - op))
+                    return 0;
+
+                /*Short runs copy a fixed 16 bytes when both buffers have the slack; the excess is overwritten later*/
+                if (literalLength <= 16 && iend - ip >= 16 && oend - op >= 16)
+                    std::memcpy(op, ip, 16);
+                else if (literalLength > 0)
+                    std::memcpy(op, ip, literalLength);
+                op += literalLength;
+                ip += literalLength;
+
+                /*Input ending after literals marks the last sequence*/
+                if (ip == iend)
+                    break;
+
+                if (iend - ip < 2)
+                    return 0;
+                size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+                ip += 2;
+                if (offset == 0 || offset > static_cast<size_t>(op - dst))
+                    return 0;
+
+                size_t matchLength = token & 15;
+                if (matchLength == 15 && !ReadLength(matchLength, ip, iend))
+                    return 0;
+                matchLength += MIN_MATCH;
+                if (matchLength > static_cast<size_t>(oend - op))
+                    return 0;
+
+                const uint8_t* match = op - offset;
+                uint8_t* end = op + matchLength;
+                if (offset >= 8 && static_cast<size_t>(oend - op) >= matchLength + 8)
+                {
+                    /*Eight bytes per step never reads what the same step writes*/
+                    do
+                    {
+                        std::memcpy(op, match, 8);
+                        op += 8;
+                        match += 8;
+                    } while (op < end);
+                }
+                else
+                {
+                    /*Close or overlapping matches repeat the last offset bytes*/
+                    while (op < end)
+                        *op++ = *match++;
+                }
+                op = end;
+            }
+
+            return static_cast<size_t>(op - dst);
+        }
+
+    }
+
+}
@@ -0,0 +1,112 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_nullrenderer.h>
+
+#include <cstring>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        using namespace Graphics;
+
+        NullRenderer::NullRenderer()
+        {
+            ResetLog();
+        }
+
+        NullRenderer::~NullRenderer()
+        {
+
+        }
+
+        bool NullRenderer::VInitialize(const RendererParams&)
+        {
+            return true;
+        }
+
+        void NullRenderer::VDeInitialize()
+        {
+
+        }
+
+        void NullRenderer::VResizeBuffers(uint32_t width, uint32_t height)
+        {
+            RenderCommand command;
+            command.type = RenderCommandType::RESIZE;
+            command.resize.width = width;
+            command.resize.height = height;
+            Log(command);
+        }
+
+        void NullRenderer::VSetClearColor(const Color& color)
+        {
+            RenderCommand command;
+            command.type = RenderCommandType::SET_CLEAR_COLOR;
+            command.color.r = color.r;
+            command.color.g = color.g;
+            command.color.b = color.b;
+            command.color.a = color.a;
+            Log(command);
+        }
+
+        void NullRenderer::VClearBuffer(ClearArgs args)
+        {
+            RenderCommand command;
+            command.type = RenderCommandType::CLEAR;
+            command.clear = args;
+            Log(command);
+        }
+
+        void NullRenderer::VPresent()
+        {
+            RenderCommand command;
+            command.type = RenderCommandType::PRESENT;
+            Log(command);
+        }
+
+        uint64_t NullRenderer::CallCount(RenderCommandType type) const
+        {
+            return m_counts[static_cast<uint32_t>(type)];
+        }
+
+        uint32_t NullRenderer::LoggedCount() const
+        {
+            return static_cast<uint32_t>(m_total < LOG_SIZE ? m_total : LOG_SIZE);
+        }
+
+        const RenderCommand& NullRenderer::Logged(uint32_t index) const
+        {
+            /*Index 0 is the oldest call still in the log*/
+            uint64_t first = (m_total > LOG_SIZE) ? m_total - LOG_SIZE : 0;
+
+            return m_log[(first + index) % LOG_SIZE];
+        }
+
+        void NullRenderer::ResetLog()
+        {
+            m_total = 0;
+            std::memset(m_counts, 0, sizeof(m_counts));
+        }
+
+        void NullRenderer::Log(const RenderCommand& command)
+        {
+            m_log[m_total % LOG_SIZE] = command;
+            m_total++;
+            m_counts[static_cast<uint32_t>(command.type)]++;
+        }
+    }
+
+}
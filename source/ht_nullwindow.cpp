@@ -0,0 +1,113 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_nullwindow.h>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        NullWindow::NullWindow(const WindowParams& params)
+        {
+            m_params = params;
+            m_frame = 0;
+            m_running = false;
+            m_woken = false;
+        }
+
+        NullWindow::~NullWindow()
+        {
+
+        }
+
+        bool NullWindow::VInitialize()
+        {
+            m_frame = 0;
+            m_running = true;
+
+            return true;
+        }
+
+        void* NullWindow::VNativeHandle()
+        {
+            return nullptr;
+        }
+
+        bool NullWindow::VIsRunning()
+        {
+            return m_running;
+        }
+
+        void NullWindow::VPollEvents()
+        {
+            m_frame++;
+
+            if (m_params.frameCount > 0 && m_frame >= m_params.frameCount)
+                VClose();
+        }
+
+        bool NullWindow::VWaitEvents(uint32_t timeoutMs)
+        {
+            /*No OS events here, so only VWake ends the wait early*/
+            bool woken;
+            {
+                std::unique_lock<std::mutex> lock(m_wakeLock);
+                woken = m_wakeSignal.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this] { return m_woken; });
+                m_woken = false;
+            }
+
+            return woken;
+        }
+
+        void NullWindow::VWake()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_wakeLock);
+                m_woken = true;
+            }
+            m_wakeSignal.notify_one();
+        }
+
+        void NullWindow::VClose()
+        {
+            m_running = false;
+        }
+
+        void NullWindow::VSwapBuffers()
+        {
+
+        }
+
+        void NullWindow::VMakeContextCurrent(bool)
+        {
+
+        }
+
+        bool NullWindow::VIsVisible()
+        {
+            return true;
+        }
+
+        bool NullWindow::VHasFocus()
+        {
+            return true;
+        }
+
+        void NullWindow::VSetDisplayFPS(bool display)
+        {
+            m_params.displayFPS = display;
+        }
+    }
+
+}
@@ -0,0 +1,387 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+
+#include <ht_pack_file.h>
+#include <ht_lz4.h>
+#include <ht_debug.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#ifdef HT_SYS_WINDOWS
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Hatchit {
+
+    namespace Game {
+
+        const uint32_t PackFile::MAGIC;
+        const uint32_t PackFile::VERSION;
+        const uint32_t PackFile::COMPRESSED;
+        const uint32_t PackFile::MAX_EXPANSION;
+
+        static const size_t PAGE_SIZE = 4096;
+
+        PackFile::PackFile()
+        {
+            m_base = nullptr;
+            m_size = 0;
+            m_entries = nullptr;
+            m_entryCount = 0;
+#ifdef HT_SYS_WINDOWS
+            m_file = nullptr;
+            m_mapping = nullptr;
+#endif
+        }
+
+        PackFile::~PackFile()
+        {
+            Close();
+        }
+
+        bool PackFile::Open(const std::string& path)
+        {
+            Close();
+
+            if (!Map(path))
+            {
+#ifdef _DEBUG
+                Core::DebugPrintF("Failed to map pack %s\n", path.c_str());
+#endif
+                return false;
+            }
+
+            /*Validate everything up front so lookups and reads can trust the table*/
+            PackHeader header;
+            bool valid = m_size >= sizeof(header);
+            if (valid)
+            {
+                std::memcpy(&header, m_base, sizeof(header));
+                uint64_t tableEnd = sizeof(header) + static_cast<uint64_t>(header.entryCount) * sizeof(PackEntry);
+                valid = header.magic == MAGIC && header.version == VERSION && tableEnd <= m_size;
+            }
+
+            if (valid)
+            {
+                m_entries = reinterpret_cast<const PackEntry*>(m_base + sizeof(header));
+                m_entryCount = header.entryCount;
+                for (uint32_t i = 0; i < m_entryCount && valid; i++)
+                {
+                    const PackEntry& entry = m_entries[i];
+                    valid = entry.offset <= m_size && entry.storedSize <= m_size - entry.offset &&
+                            (i == 0 || m_entries[i - 1].id < entry.id) &&
+                            ((entry.flags & COMPRESSED) || entry.storedSize == entry.size) &&
+                            entry.size <= static_cast<uint64_t>(entry.storedSize) * MAX_EXPANSION + 16;
+                }
+            }
+
+            if (!valid)
+            {
+#ifdef _DEBUG
+                Core::DebugPrintF("Pack %s is not a valid version %u pack\n", path.c_str(), VERSION);
+#endif
+                Close();
+                return false;
+            }
+
+            m_path = path;
+            return true;
+        }
+
+        void PackFile::Close()
+        {
+            Unmap();
+            m_entries = nullptr;
+            m_entryCount = 0;
+            m_path.clear();
+        }
+
+        bool PackFile::IsOpen() const
+        {
+            return m_base != nullptr;
+        }
+
+        uint64_t PackFile::Hash(const std::string& name)
+        {
+            uint64_t hash = 14695981039346656037ULL;
+            for (size_t i = 0; i < name.size(); i++)
+            {
+                hash ^= static_cast<uint8_t>(name[i]);
+                hash *= 1099511628211ULL;
+            }
+            return hash;
+        }
+
+        const PackEntry* PackFile::Find(uint64_t id) const
+        {
+            const PackEntry* end = m_entries + m_entryCount;
+            const PackEntry* entry = std::lower_bound(m_entries, end, id,
+                [](const PackEntry& e, uint64_t value) { return e.id < value; });
+
+            return (entry != end && entry->id == id) ? entry : nullptr;
+        }
+
+        const uint8_t* PackFile::Data(const PackEntry& entry) const
+        {
+            return m_base + entry.offset;
+        }
+
+        bool PackFile::Read(const PackEntry& entry, uint8_t* out) const
+        {
+            if (!(entry.flags & COMPRESSED))
+            {
+                std::memcpy(out, Data(entry), entry.size);
+                return true;
+            }
+
+            return LZ4::Decompress(Data(entry), entry.storedSize, out, entry.size) == entry.size;
+        }
+
+        void PackFile::Prefetch(const PackEntry& entry) const
+        {
+            if (entry.storedSize == 0)
+                return;
+
+            const uint8_t* first = m_base + entry.offset;
+            const uint8_t* last = first + entry.storedSize - 1;
+
+#ifndef HT_SYS_WINDOWS
+            uintptr_t page = reinterpret_cast<uintptr_t>(first) & ~static_cast<uintptr_t>(PAGE_SIZE - 1);
+            madvise(reinterpret_cast<void*>(page), reinterpret_cast<uintptr_t>(last) + 1 - page, MADV_WILLNEED);
+#endif
+
+            /*Touch one byte per page; the advice alone does not guarantee residency*/
+            volatile uint8_t sink = 0;
+            for (const uint8_t* p = first; p <= last; p += PAGE_SIZE)
+                sink ^= *p;
+            sink ^= *last;
+        }
+
+        uint32_t PackFile::EntryCount() const
+        {
+            return m_entryCount;
+        }
+
+        const PackEntry* PackFile::Entries() const
+        {
+            return m_entries;
+        }
+
+        const std::string& PackFile::Path() const
+        {
+            return m_path;
+        }
+
+#ifdef HT_SYS_WINDOWS
+        bool PackFile::Map(const std::string& path)
+        {
+            HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                      FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+                return false;
+
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+            {
+                CloseHandle(file);
+                return false;
+            }
+
+            HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            void* base = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+            if (!base)
+            {
+                if (mapping)
+                    CloseHandle(mapping);
+                CloseHandle(file);
+                return false;
+            }
+
+            m_file = file;
+            m_mapping = mapping;
+            m_base = static_cast<const uint8_t*>(base);
+            m_size = static_cast<size_t>(size.QuadPart);
+            return true;
+        }
+
+        void PackFile::Unmap()
+        {
+            if (m_base)
+                UnmapViewOfFile(m_base);
+            if (m_mapping)
+                CloseHandle(m_mapping);
+            if (m_file)
+                CloseHandle(m_file);
+
+            m_base = nullptr;
+            m_size = 0;
+            m_mapping = nullptr;
+            m_file = nullptr;
+        }
+#else
+        bool PackFile::Map(const std::string& path)
+        {
+            int file = open(path.c_str(), O_RDONLY);
+            if (file < 0)
+                return false;
+
+            struct stat info;
+            if (fstat(file, &info) != 0 || info.st_size == 0)
+            {
+                close(file);
+                return false;
+            }
+
+            /*The mapping keeps the file alive, so the descriptor can go now*/
+            void* base = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+            close(file);
+            if (base == MAP_FAILED)
+                return false;
+
+            m_base = static_cast<const uint8_t*>(base);
+            m_size = static_cast<size_t>(info.st_size);
+            return true;
+        }
+
+        void PackFile::Unmap()
+        {
+            if (m_base)
+                munmap(const_cast<uint8_t*>(m_base), m_size);
+
+            m_base = nullptr;
+            m_size = 0;
+        }
+#endif
+
+        PackWriter::PackWriter()
+        {
+        }
+
+        bool PackWriter::Add(const std::string& name, const void* data, size_t size, bool compress)
+        {
+            if (size > 0xFFFFFFFFu)
+                return false;
+
+            Item item;
+            item.id = PackFile::Hash(name);
+            item.size = static_cast<uint32_t>(size);
+            item.flags = 0;
+
+            for (size_t i = 0; i < m_items.size(); i++)
+            {
+                if (m_items[i].id == item.id)
+                {
+#ifdef _DEBUG
+                    Core::DebugPrintF("Pack entry %s collides with an existing entry\n", name.c_str());
+#endif
+                    return false;
+                }
+            }
+
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            if (compress && size > 0)
+            {
+                item.stored.resize(LZ4::CompressBound(size));
+                size_t compressed = LZ4::Compress(bytes, size, item.stored.data(), item.stored.size());
+                if (compressed > 0 && compressed < size)
+                {
+                    item.stored.resize(compressed);
+                    item.flags = PackFile::COMPRESSED;
+                }
+            }
+
+            if (!item.flags)
+                item.stored.assign(bytes, bytes + size);
+
+            m_items.push_back(std::move(item));
+            return true;
+        }
+
+        bool PackWriter::Write(const std::string& path, uint32_t alignment) const
+        {
+            if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+                return false;
+
+            std::vector<const Item*> sorted;
+            for (size_t i = 0; i < m_items.size(); i++)
+                sorted.push_back(&m_items[i]);
+            std::sort(sorted.begin(), sorted.end(), [](const Item* a, const Item* b) { return a->id < b->id; });
+
+            PackHeader header;
+            header.magic = PackFile::MAGIC;
+            header.version = PackFile::VERSION;
+            header.entryCount = static_cast<uint32_t>(sorted.size());
+            header.alignment = alignment;
+
+            std::vector<PackEntry> entries(sorted.size());
+            uint64_t offset = sizeof(header) + entries.size() * sizeof(PackEntry);
+            for (size_t i = 0; i < sorted.size(); i++)
+            {
+                offset = (offset + alignment - 1) & ~static_cast<uint64_t>(alignment - 1);
+
+                PackEntry& entry = entries[i];
+                entry.id = sorted[i]->id;
+                entry.offset = offset;
+                entry.storedSize = static_cast<uint32_t>(sorted[i]->stored.size());
+                entry.size = sorted[i]->size;
+                entry.flags = sorted[i]->flags;
+                entry.reserved = 0;
+
+                offset += entry.storedSize;
+            }
+
+            FILE* file = std::fopen(path.c_str(), "wb");
+            if (!file)
+                return false;
+
+            bool written = std::fwrite(&header, sizeof(header), 1, file) == 1;
+            if (written && !entries.empty())
+                written = std::fwrite(entries.data(), sizeof(PackEntry), entries.size(), file) == entries.size();
+
+            static const uint8_t padding[256] = { 0 };
+            uint64_t position = sizeof(header) + entries.size() * sizeof(PackEntry);
+            for (size_t i = 0; i < sorted.size() && written; i++)
+            {
+                while (position < entries[i].offset && written)
+                {
+                    size_t count = static_cast<size_t>(std::min<uint64_t>(entries[i].offset - position, sizeof(padding)));
+                    written = std::fwrite(padding, 1, count, file) == count;
+                    position += count;
+                }
+
+                const std::vector<uint8_t>& stored = sorted[i]->stored;
+                if (written && !stored.empty())
+                    written = std::fwrite(stored.data(), 1, stored.size(), file) == stored.size();
+                position += stored.size();
+            }
+
+            return (std::fclose(file) == 0) && written;
+        }
+
+        void PackWriter::Clear()
+        {
+            m_items.clear();
+        }
+
+    }
+
+}
@@ -0,0 +1,99 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_render_command_buffer.h>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        using namespace Graphics;
+
+        RenderCommandBuffer::RenderCommandBuffer()
+        {
+            m_order = 0;
+        }
+
+        void RenderCommandBuffer::Reserve(uint32_t capacity)
+        {
+            m_commands.reserve(capacity);
+        }
+
+        void RenderCommandBuffer::Reset()
+        {
+            m_commands.clear();
+        }
+
+        void RenderCommandBuffer::SetOrder(uint32_t order)
+        {
+            m_order = order;
+        }
+
+        uint32_t RenderCommandBuffer::Order() const
+        {
+            return m_order;
+        }
+
+        void RenderCommandBuffer::SetClearColor(const Color& color)
+        {
+            RenderCommand command;
+            command.type = RenderCommandType::SET_CLEAR_COLOR;
+            command.color.r = color.r;
+            command.color.g = color.g;
+            command.color.b = color.b;
+            command.color.a = color.a;
+            m_commands.push_back(command);
+        }
+
+        void RenderCommandBuffer::Clear(ClearArgs args)
+        {
+            RenderCommand command;
+            command.type = RenderCommandType::CLEAR;
+            command.clear = args;
+            m_commands.push_back(command);
+        }
+
+        void RenderCommandBuffer::ResizeBuffers(uint32_t width, uint32_t height)
+        {
+            RenderCommand command;
+            command.type = RenderCommandType::RESIZE;
+            command.resize.width = width;
+            command.resize.height = height;
+            m_commands.push_back(command);
+        }
+
+        void RenderCommandBuffer::Present()
+        {
+            RenderCommand command;
+            command.type = RenderCommandType::PRESENT;
+            m_commands.push_back(command);
+        }
+
+        void RenderCommandBuffer::Record(const RenderCommand& command)
+        {
+            m_commands.push_back(command);
+        }
+
+        uint32_t RenderCommandBuffer::Count() const
+        {
+            return static_cast<uint32_t>(m_commands.size());
+        }
+
+        const RenderCommand* RenderCommandBuffer::Commands() const
+        {
+            return m_commands.data();
+        }
+    }
+
+}
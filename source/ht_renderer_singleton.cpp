@@ -18,6 +18,10 @@
 #include <ht_dxrenderer.h>
 #endif
 #include <ht_glrenderer.h>
+#include <ht_nullrenderer.h>
+#include <ht_static_backend.h>
+
+#include <cassert>
 
 namespace Hatchit {
 
@@ -25,21 +29,58 @@ namespace Hatchit {
 
         using namespace Graphics;
 
-        bool Renderer::Initialize(const RendererParams& params)
+        Renderer::Renderer()
+        {
+            m_renderer = nullptr;
+            m_framesInFlight = 1;
+            m_writeIndex = 0;
+            m_readIndex = 0;
+            m_threaded = false;
+            m_stopping = false;
+            for (uint32_t i = 0; i < 4; i++)
+                m_clearColor[i] = 0.0f;
+            for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+            {
+                m_frames[i].Reserve(256);
+                m_queued[i] = false;
+            }
+        }
+
+        bool Renderer::Initialize(const RendererParams& params, bool headless)
         {
             Renderer& _instance = Renderer::instance();
 
-#ifdef HT_SYS_LINUX
-            _instance.m_renderer = new GLRenderer;
+#ifdef HT_STATIC_BACKEND
+            /*The backend is fixed at compile time, so the caller must ask for the one that was built*/
+            assert(headless == STATIC_BACKEND_HEADLESS && "Renderer::Initialize: headless does not match the static backend");
+            (void)headless;
+
+            StaticRendererType* renderer = new StaticRendererType;
+            FrameBackend::BindRenderer(renderer);
+            _instance.m_renderer = renderer;
 #else
-            if (params.renderer == RendererType::DIRECTX)
-                _instance.m_renderer = new DXRenderer;
+            if (headless)
+                _instance.m_renderer = new NullRenderer;
             else
+            {
+#ifdef HT_SYS_LINUX
                 _instance.m_renderer = new GLRenderer;
+#else
+                if (params.renderer == RendererType::DIRECTX)
+                    _instance.m_renderer = new DXRenderer;
+                else
+                    _instance.m_renderer = new GLRenderer;
+#endif
+            }
 #endif
             if (!_instance.m_renderer->VInitialize(params))
                 return false;
 
+            _instance.m_clearColor[0] = params.clearColor.r;
+            _instance.m_clearColor[1] = params.clearColor.g;
+            _instance.m_clearColor[2] = params.clearColor.b;
+            _instance.m_clearColor[3] = params.clearColor.a;
+
             return true;
         }
 
@@ -47,9 +88,19 @@ namespace Hatchit {
         {
             Renderer& _instance = Renderer::instance();
 
+            StopThread();
+
+            /*Also reached when startup failed before the renderer was created*/
+            if (!_instance.m_renderer)
+                return;
+
             _instance.m_renderer->VDeInitialize();
 
             delete _instance.m_renderer;
+            _instance.m_renderer = nullptr;
+#ifdef HT_STATIC_BACKEND
+            FrameBackend::BindRenderer(nullptr);
+#endif
         }
 
         void Renderer::SetClearColor(const Color& color)
@@ -79,6 +130,241 @@ namespace Hatchit {
 
             _instance.m_renderer->VResizeBuffers(width, height);
         }
+
+        void Renderer::Submit(const RenderCommandBuffer& buffer)
+        {
+            const RenderCommand* commands = buffer.Commands();
+            uint32_t count = buffer.Count();
+            for (uint32_t i = 0; i < count; i++)
+                Execute(commands[i]);
+        }
+
+        static uint64_t SubmitKey(const RenderCommandBuffer* const* buffers, uint32_t index)
+        {
+            /*Order key first, then submission index, so equal keys keep their order*/
+            return (static_cast<uint64_t>(buffers[index]->Order()) << 32) | index;
+        }
+
+        void Renderer::Submit(const RenderCommandBuffer* const* buffers, uint32_t count)
+        {
+            static const uint32_t MAX_BUFFERS = 64;
+
+            /*
+            * Merge by order key without scratch memory: each pass insertion-sorts
+            * the MAX_BUFFERS smallest keys after the last one submitted, so any
+            * count comes out fully ordered (one pass for up to MAX_BUFFERS).
+            */
+            uint32_t sorted[MAX_BUFFERS];
+            uint64_t last = 0;
+            uint32_t submitted = 0;
+            while (submitted < count)
+            {
+                uint32_t sortedCount = 0;
+                for (uint32_t i = 0; i < count; i++)
+                {
+                    uint64_t key = SubmitKey(buffers, i);
+                    if (submitted > 0 && key <= last)
+                        continue;
+                    if (sortedCount == MAX_BUFFERS && key >= SubmitKey(buffers, sorted[MAX_BUFFERS - 1]))
+                        continue;
+
+                    uint32_t j = (sortedCount < MAX_BUFFERS) ? sortedCount++ : MAX_BUFFERS - 1;
+                    while (j > 0 && SubmitKey(buffers, sorted[j - 1]) > key)
+                    {
+                        sorted[j] = sorted[j - 1];
+                        j--;
+                    }
+                    sorted[j] = i;
+                }
+
+                for (uint32_t i = 0; i < sortedCount; i++)
+                    Submit(*buffers[sorted[i]]);
+
+                last = SubmitKey(buffers, sorted[sortedCount - 1]);
+                submitted += sortedCount;
+            }
+        }
+
+        IRenderer* Renderer::Backend()
+        {
+            Renderer& _instance = Renderer::instance();
+
+            return _instance.m_renderer;
+        }
+
+        void Renderer::Execute(const RenderCommand& command)
+        {
+            FrameBackend::Execute(command);
+        }
+
+        bool Renderer::StartThread(const RenderThreadParams& params)
+        {
+            Renderer& _instance = Renderer::instance();
+
+            if (_instance.m_threaded)
+                return true;
+
+            _instance.m_threadParams = params;
+            _instance.m_framesInFlight = params.framesInFlight;
+            if (_instance.m_framesInFlight < 1)
+                _instance.m_framesInFlight = 1;
+            if (_instance.m_framesInFlight > MAX_FRAMES_IN_FLIGHT)
+                _instance.m_framesInFlight = MAX_FRAMES_IN_FLIGHT;
+
+            _instance.m_writeIndex = 0;
+            _instance.m_readIndex = 0;
+            for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+                _instance.m_queued[i] = false;
+
+            _instance.m_stopping = false;
+            _instance.m_threaded = true;
+            _instance.m_thread = std::thread(&Renderer::ThreadMain);
+
+            return true;
+        }
+
+        void Renderer::StopThread()
+        {
+            Renderer& _instance = Renderer::instance();
+
+            if (!_instance.m_threaded)
+                return;
+
+            {
+                std::lock_guard<std::mutex> lock(_instance.m_frameMutex);
+                _instance.m_stopping = true;
+            }
+            _instance.m_frameQueued.notify_one();
+
+            _instance.m_thread.join();
+            _instance.m_threaded = false;
+            _instance.m_framesInFlight = 1;
+            _instance.m_writeIndex = 0;
+        }
+
+        bool Renderer::IsThreaded()
+        {
+            Renderer& _instance = Renderer::instance();
+
+            return _instance.m_threaded;
+        }
+
+        RenderCommandBuffer& Renderer::BeginFrame()
+        {
+            Renderer& _instance = Renderer::instance();
+
+            uint32_t slot = _instance.m_writeIndex;
+
+            /*Fence: wait until the render thread has retired whatever used this slot*/
+            if (_instance.m_threaded)
+            {
+                std::unique_lock<std::mutex> lock(_instance.m_frameMutex);
+                _instance.m_frameRetired.wait(lock, [&_instance, slot]() {
+                    return !_instance.m_queued[slot];
+                });
+            }
+
+            RenderCommandBuffer& buffer = _instance.m_frames[slot];
+            buffer.Reset();
+
+            return buffer;
+        }
+
+        void Renderer::EndFrame()
+        {
+            Renderer& _instance = Renderer::instance();
+
+            uint32_t slot = _instance.m_writeIndex;
+
+            if (!_instance.m_threaded)
+            {
+                ApplyLatestView();
+                Submit(_instance.m_frames[slot]);
+                return;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(_instance.m_frameMutex);
+                _instance.m_queued[slot] = true;
+            }
+            _instance.m_frameQueued.notify_one();
+
+            _instance.m_writeIndex = (slot + 1) % _instance.m_framesInFlight;
+        }
+
+        void Renderer::ThreadMain()
+        {
+            Renderer& _instance = Renderer::instance();
+
+            if (_instance.m_threadParams.bindContext)
+                _instance.m_threadParams.bindContext(true);
+
+            for (;;)
+            {
+                uint32_t slot = _instance.m_readIndex;
+
+                {
+                    std::unique_lock<std::mutex> lock(_instance.m_frameMutex);
+                    _instance.m_frameQueued.wait(lock, [&_instance, slot]() {
+                        return _instance.m_queued[slot] || _instance.m_stopping;
+                    });
+
+                    /*Drain every queued frame before honouring a stop request*/
+                    if (!_instance.m_queued[slot])
+                        break;
+                }
+
+                ApplyLatestView();
+                Submit(_instance.m_frames[slot]);
+
+                if (_instance.m_threadParams.swapBuffers)
+                    _instance.m_threadParams.swapBuffers();
+
+                {
+                    std::lock_guard<std::mutex> lock(_instance.m_frameMutex);
+                    _instance.m_queued[slot] = false;
+                }
+                _instance.m_frameRetired.notify_one();
+
+                _instance.m_readIndex = (slot + 1) % _instance.m_framesInFlight;
+            }
+
+            if (_instance.m_threadParams.bindContext)
+                _instance.m_threadParams.bindContext(false);
+        }
+
+        RenderView& Renderer::BeginView()
+        {
+            Renderer& _instance = Renderer::instance();
+
+            return _instance.m_views.WriteBuffer();
+        }
+
+        void Renderer::PublishView()
+        {
+            Renderer& _instance = Renderer::instance();
+
+            _instance.m_views.Publish();
+        }
+
+        void Renderer::ApplyLatestView()
+        {
+            Renderer& _instance = Renderer::instance();
+
+            if (!_instance.m_views.Acquire())
+                return;
+
+            const RenderView& view = _instance.m_views.ReadBuffer();
+
+            float* current = _instance.m_clearColor;
+            if (current[0] != view.clearColor[0] || current[1] != view.clearColor[1] ||
+                current[2] != view.clearColor[2] || current[3] != view.clearColor[3])
+            {
+                for (uint32_t i = 0; i < 4; i++)
+                    current[i] = view.clearColor[i];
+                _instance.m_renderer->VSetClearColor(Color(current[0], current[1], current[2], current[3]));
+            }
+        }
     }
 
 }
\ No newline at end of file
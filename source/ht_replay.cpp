@@ -0,0 +1,418 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+
+#include <ht_replay.h>
+#include <ht_debug.h>
+#include <ht_eventbus_singleton.h>
+#include <ht_lz4.h>
+#include <ht_time_singleton.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        const uint32_t Replay::MAGIC;
+        const uint32_t Replay::VERSION;
+        const uint32_t Replay::BLOCK_SIZE;
+        const uint8_t Replay::VISIBLE;
+        const uint8_t Replay::FOCUSED;
+
+        Replay::Replay()
+        {
+            m_mode = ReplayMode::OFF;
+            m_file = nullptr;
+            m_blockSize = 0;
+            m_cursor = 0;
+            m_exhausted = false;
+            m_frames = 0;
+        }
+
+        bool Replay::Initialize(ReplayMode mode, const std::string& path)
+        {
+            Replay& _instance = Replay::instance();
+
+            _instance.m_mode = ReplayMode::OFF;
+            _instance.m_path = path;
+            _instance.m_blockSize = 0;
+            _instance.m_cursor = 0;
+            _instance.m_exhausted = false;
+            _instance.m_frames = 0;
+
+            if (mode == ReplayMode::OFF)
+                return true;
+
+            if (mode == ReplayMode::RECORD)
+            {
+                _instance.m_file = std::fopen(path.c_str(), "wb");
+                if (!_instance.m_file)
+                {
+#ifdef _DEBUG
+                    Core::DebugPrintF("Replay: can't create %s\n", path.c_str());
+#endif
+                    return false;
+                }
+
+                /*Writing the header now also gets the stream's own buffer allocated before the first frame*/
+                Header header;
+                header.magic = MAGIC;
+                header.version = VERSION;
+                if (std::fwrite(&header, sizeof(header), 1, _instance.m_file) != 1)
+                {
+                    std::fclose(_instance.m_file);
+                    _instance.m_file = nullptr;
+                    return false;
+                }
+
+                _instance.m_block.resize(BLOCK_SIZE);
+                _instance.m_compressed.resize(LZ4::CompressBound(BLOCK_SIZE));
+                _instance.m_mode = mode;
+                return true;
+            }
+
+            FILE* file = std::fopen(path.c_str(), "rb");
+            bool loaded = file && Load(file);
+            if (file)
+                std::fclose(file);
+            if (!loaded)
+            {
+#ifdef _DEBUG
+                Core::DebugPrintF("Replay: %s is missing or not a valid replay\n", path.c_str());
+#endif
+                std::vector<uint8_t>().swap(_instance.m_stream);
+                return false;
+            }
+
+            _instance.m_mode = mode;
+            return true;
+        }
+
+        void Replay::DeInitialize()
+        {
+            Replay& _instance = Replay::instance();
+
+            if (_instance.m_mode == ReplayMode::RECORD && _instance.m_file)
+            {
+                Flush();
+                if (_instance.m_file)
+                    std::fclose(_instance.m_file);
+                _instance.m_file = nullptr;
+            }
+
+#ifdef _DEBUG
+            if (_instance.m_mode != ReplayMode::OFF)
+                Core::DebugPrintF("Replay: %s %llu frame(s) %s %s\n",
+                    _instance.m_mode == ReplayMode::RECORD ? "recorded" : "played",
+                    static_cast<unsigned long long>(_instance.m_frames),
+                    _instance.m_mode == ReplayMode::RECORD ? "to" : "from",
+                    _instance.m_path.c_str());
+#endif
+
+            _instance.m_mode = ReplayMode::OFF;
+            std::vector<uint8_t>().swap(_instance.m_block);
+            std::vector<uint8_t>().swap(_instance.m_compressed);
+            std::vector<uint8_t>().swap(_instance.m_stream);
+        }
+
+        ReplayMode Replay::Mode()
+        {
+            Replay& _instance = Replay::instance();
+
+            return _instance.m_mode;
+        }
+
+        bool Replay::IsPlaying()
+        {
+            Replay& _instance = Replay::instance();
+
+            return _instance.m_mode == ReplayMode::PLAY;
+        }
+
+        bool Replay::Tick()
+        {
+            Replay& _instance = Replay::instance();
+
+            switch (_instance.m_mode)
+            {
+            case ReplayMode::RECORD:
+                Time::Tick();
+                WriteVarint(Time::DeltaTicks());
+                break;
+
+            case ReplayMode::PLAY:
+            {
+                uint64_t delta;
+                if (_instance.m_exhausted || !ReadVarint(delta))
+                {
+                    _instance.m_exhausted = true;
+                    return false;
+                }
+                Time::Tick(delta);
+                break;
+            }
+
+            default:
+                Time::Tick();
+                return true;
+            }
+
+            _instance.m_frames++;
+            return true;
+        }
+
+        void Replay::Events()
+        {
+            Replay& _instance = Replay::instance();
+
+            if (_instance.m_mode == ReplayMode::RECORD)
+            {
+                /*Only what the window published; posted events come from the game itself*/
+                uint32_t count;
+                const Event* events = EventBus::PublishedEvents(count);
+                WriteVarint(count);
+                for (uint32_t i = 0; i < count; i++)
+                {
+                    const Event& event = events[i];
+                    uint8_t type = static_cast<uint8_t>(event.type);
+                    Write(&type, sizeof(type));
+                    Write(&event.timestamp, sizeof(event.timestamp));
+                    Write(&event.window, PayloadSize(event.type));
+                }
+            }
+            else if (_instance.m_mode == ReplayMode::PLAY && !_instance.m_exhausted)
+            {
+                uint64_t count;
+                if (!ReadVarint(count))
+                {
+                    _instance.m_exhausted = true;
+                    return;
+                }
+
+                for (uint64_t i = 0; i < count; i++)
+                {
+                    Event event;
+                    std::memset(&event, 0, sizeof(event));
+
+                    uint8_t type;
+                    if (!Read(&type, sizeof(type)) || type >= static_cast<uint8_t>(EventType::COUNT))
+                    {
+                        _instance.m_exhausted = true;
+                        return;
+                    }
+                    event.type = static_cast<EventType>(type);
+                    if (!Read(&event.timestamp, sizeof(event.timestamp)) || !Read(&event.window, PayloadSize(event.type)))
+                    {
+                        _instance.m_exhausted = true;
+                        return;
+                    }
+
+                    EventBus::Publish(event);
+                }
+            }
+        }
+
+        void Replay::WindowState(bool& visible, bool& focused)
+        {
+            Replay& _instance = Replay::instance();
+
+            if (_instance.m_mode == ReplayMode::RECORD)
+            {
+                uint8_t flags = (visible ? VISIBLE : 0) | (focused ? FOCUSED : 0);
+                Write(&flags, sizeof(flags));
+            }
+            else if (_instance.m_mode == ReplayMode::PLAY && !_instance.m_exhausted)
+            {
+                uint8_t flags;
+                if (!Read(&flags, sizeof(flags)))
+                {
+                    _instance.m_exhausted = true;
+                    return;
+                }
+                visible = (flags & VISIBLE) != 0;
+                focused = (flags & FOCUSED) != 0;
+            }
+        }
+
+        uint64_t Replay::Frames()
+        {
+            Replay& _instance = Replay::instance();
+
+            return _instance.m_frames;
+        }
+
+        size_t Replay::PayloadSize(EventType type)
+        {
+            switch (type)
+            {
+            case EventType::QUIT:
+                return 0;
+
+            case EventType::KEY:
+                return sizeof(KeyEventData);
+
+            case EventType::MOUSE_MOTION:
+            case EventType::MOUSE_BUTTON:
+            case EventType::MOUSE_WHEEL:
+                return sizeof(MouseEventData);
+
+            case EventType::CONTROLLER_ADDED:
+            case EventType::CONTROLLER_REMOVED:
+            case EventType::CONTROLLER_BUTTON:
+            case EventType::CONTROLLER_AXIS:
+                return sizeof(ControllerEventData);
+
+            case EventType::USER:
+                return sizeof(UserEventData);
+
+            default:
+                return sizeof(WindowEventData);
+            }
+        }
+
+        void Replay::Write(const void* data, size_t size)
+        {
+            Replay& _instance = Replay::instance();
+
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            while (size > 0)
+            {
+                size_t count = std::min(size, BLOCK_SIZE - _instance.m_blockSize);
+                std::memcpy(_instance.m_block.data() + _instance.m_blockSize, bytes, count);
+                _instance.m_blockSize += count;
+                bytes += count;
+                size -= count;
+
+                if (_instance.m_blockSize == BLOCK_SIZE)
+                    Flush();
+            }
+        }
+
+        void Replay::WriteVarint(uint64_t value)
+        {
+            uint8_t bytes[10];
+            size_t count = 0;
+            do
+            {
+                uint8_t byte = static_cast<uint8_t>(value & 0x7F);
+                value >>= 7;
+                bytes[count++] = value ? (byte | 0x80) : byte;
+            } while (value);
+
+            Write(bytes, count);
+        }
+
+        bool Replay::Flush()
+        {
+            Replay& _instance = Replay::instance();
+
+            if (_instance.m_blockSize == 0)
+                return true;
+
+            size_t size = _instance.m_blockSize;
+            _instance.m_blockSize = 0;
+            if (!_instance.m_file)
+                return false;
+
+            /*Blocks that don't shrink are stored as they are*/
+            const uint8_t* stored = _instance.m_compressed.data();
+            size_t storedSize = LZ4::Compress(_instance.m_block.data(), size, _instance.m_compressed.data(), _instance.m_compressed.size());
+            if (storedSize == 0 || storedSize >= size)
+            {
+                stored = _instance.m_block.data();
+                storedSize = size;
+            }
+
+            BlockHeader header;
+            header.size = static_cast<uint32_t>(size);
+            header.storedSize = static_cast<uint32_t>(storedSize);
+            if (std::fwrite(&header, sizeof(header), 1, _instance.m_file) != 1 ||
+                std::fwrite(stored, 1, storedSize, _instance.m_file) != storedSize)
+            {
+#ifdef _DEBUG
+                Core::DebugPrintF("Replay: write to %s failed, recording stopped\n", _instance.m_path.c_str());
+#endif
+                std::fclose(_instance.m_file);
+                _instance.m_file = nullptr;
+                return false;
+            }
+
+            return true;
+        }
+
+        bool Replay::Read(void* data, size_t size)
+        {
+            Replay& _instance = Replay::instance();
+
+            if (size > _instance.m_stream.size() - _instance.m_cursor)
+                return false;
+
+            std::memcpy(data, _instance.m_stream.data() + _instance.m_cursor, size);
+            _instance.m_cursor += size;
+            return true;
+        }
+
+        bool Replay::ReadVarint(uint64_t& value)
+        {
+            value = 0;
+            for (uint32_t shift = 0; shift < 64; shift += 7)
+            {
+                uint8_t byte;
+                if (!Read(&byte, sizeof(byte)))
+                    return false;
+
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80))
+                    return true;
+            }
+
+            return false;
+        }
+
+        bool Replay::Load(FILE* file)
+        {
+            Replay& _instance = Replay::instance();
+
+            Header header;
+            if (std::fread(&header, sizeof(header), 1, file) != 1 || header.magic != MAGIC || header.version != VERSION)
+                return false;
+
+            std::vector<uint8_t> stored(LZ4::CompressBound(BLOCK_SIZE));
+            _instance.m_stream.clear();
+
+            BlockHeader block;
+            while (std::fread(&block, sizeof(block), 1, file) == 1)
+            {
+                if (block.size == 0 || block.size > BLOCK_SIZE || block.storedSize > block.size)
+                    return false;
+                if (std::fread(stored.data(), 1, block.storedSize, file) != block.storedSize)
+                    return false;
+
+                size_t offset = _instance.m_stream.size();
+                _instance.m_stream.resize(offset + block.size);
+                uint8_t* dst = _instance.m_stream.data() + offset;
+                if (block.storedSize == block.size)
+                    std::memcpy(dst, stored.data(), block.size);
+                else if (LZ4::Decompress(stored.data(), block.storedSize, dst, block.size) != block.size)
+                    return false;
+            }
+
+            return std::feof(file) != 0;
+        }
+
+    }
+
+}
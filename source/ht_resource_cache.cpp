@@ -0,0 +1,358 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+
+#include <ht_resource_cache.h>
+#include <ht_debug.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        const uint32_t ResourceCache::NONE;
+
+        ResourceCache::ResourceCache()
+        {
+            m_lruHead = NONE;
+            m_lruTail = NONE;
+            std::memset(&m_stats, 0, sizeof(m_stats));
+        }
+
+        bool ResourceCache::Initialize(size_t budgetBytes)
+        {
+            ResourceCache& _instance = ResourceCache::instance();
+
+            _instance.m_lruHead = NONE;
+            _instance.m_lruTail = NONE;
+            std::memset(&_instance.m_stats, 0, sizeof(_instance.m_stats));
+            _instance.m_stats.budgetBytes = budgetBytes;
+
+            return true;
+        }
+
+        void ResourceCache::DeInitialize()
+        {
+            ResourceCache& _instance = ResourceCache::instance();
+
+            _instance.m_slots.clear();
+            _instance.m_freeSlots.clear();
+            _instance.m_lookup.clear();
+            _instance.m_deferred.clear();
+            _instance.m_lruHead = NONE;
+            _instance.m_lruTail = NONE;
+        }
+
+        ResourceHandle ResourceCache::Acquire(const std::string& name)
+        {
+            return Acquire(PackFile::Hash(name));
+        }
+
+        ResourceHandle ResourceCache::Acquire(uint64_t id)
+        {
+            ResourceCache& _instance = ResourceCache::instance();
+
+            ResourceHandle handle;
+
+            std::unordered_map<uint64_t, uint32_t>::iterator found = _instance.m_lookup.find(id);
+            if (found != _instance.m_lookup.end())
+            {
+                Slot& slot = _instance.m_slots[found->second];
+                if (slot.refCount++ == 0)
+                {
+                    if (slot.state == ResourceState::READY)
+                        UnlinkLRU(found->second);
+                    _instance.m_stats.referenced++;
+                }
+                _instance.m_stats.hits++;
+
+                handle.index = found->second;
+                handle.generation = slot.generation;
+                return handle;
+            }
+
+            uint32_t index;
+            if (!_instance.m_freeSlots.empty())
+            {
+                index = _instance.m_freeSlots.back();
+                _instance.m_freeSlots.pop_back();
+            }
+            else
+            {
+                index = static_cast<uint32_t>(_instance.m_slots.size());
+                _instance.m_slots.push_back(Slot());
+                _instance.m_slots.back().generation = 0;
+            }
+
+            Slot& slot = _instance.m_slots[index];
+            slot.id = id;
+            slot.refCount = 1;
+            slot.state = ResourceState::LOADING;
+            slot.data = nullptr;
+            slot.size = 0;
+            slot.prev = NONE;
+            slot.next = NONE;
+            _instance.m_lookup[id] = index;
+            _instance.m_stats.misses++;
+            _instance.m_stats.referenced++;
+
+            /*Not in any mounted pack: fail now rather than on every later Acquire*/
+            if (!Request(index))
+            {
+                slot.state = ResourceState::FAILED;
+                _instance.m_stats.failures++;
+            }
+
+            handle.index = index;
+            handle.generation = slot.generation;
+            return handle;
+        }
+
+        void ResourceCache::AddRef(ResourceHandle handle)
+        {
+            ResourceCache& _instance = ResourceCache::instance();
+
+            Slot* slot = Lookup(handle);
+            if (slot && slot->refCount++ == 0)
+            {
+                if (slot->state == ResourceState::READY)
+                    UnlinkLRU(handle.index);
+                _instance.m_stats.referenced++;
+            }
+        }
+
+        void ResourceCache::Release(ResourceHandle handle)
+        {
+            ResourceCache& _instance = ResourceCache::instance();
+
+            Slot* slot = Lookup(handle);
+            if (!slot || slot->refCount == 0)
+                return;
+
+            if (--slot->refCount == 0)
+            {
+                _instance.m_stats.referenced--;
+                Unreferenced(handle.index);
+            }
+        }
+
+        bool ResourceCache::IsValid(ResourceHandle handle)
+        {
+            return Lookup(handle) != nullptr;
+        }
+
+        ResourceState ResourceCache::State(ResourceHandle handle)
+        {
+            Slot* slot = Lookup(handle);
+
+            return slot ? slot->state : ResourceState::INVALID;
+        }
+
+        const uint8_t* ResourceCache::Data(ResourceHandle handle, size_t& size)
+        {
+            Slot* slot = Lookup(handle);
+            if (!slot || slot->state != ResourceState::READY)
+            {
+                size = 0;
+                return nullptr;
+            }
+
+            size = slot->size;
+            return slot->data;
+        }
+
+        void ResourceCache::Update()
+        {
+            ResourceCache& _instance = ResourceCache::instance();
+
+            /*Retry in request order; stop at the first the streamer still can't take*/
+            size_t retried = 0;
+            for (; retried < _instance.m_deferred.size(); retried++)
+            {
+                uint32_t index = _instance.m_deferred[retried];
+                if (!AssetStreamer::Load(_instance.m_slots[index].id, &ResourceCache::OnLoaded, reinterpret_cast<void*>(static_cast<uintptr_t>(index))))
+                    break;
+            }
+            _instance.m_deferred.erase(_instance.m_deferred.begin(), _instance.m_deferred.begin() + retried);
+
+            Trim();
+        }
+
+        void ResourceCache::SetBudget(size_t budgetBytes)
+        {
+            ResourceCache& _instance = ResourceCache::instance();
+
+            _instance.m_stats.budgetBytes = budgetBytes;
+            Trim();
+        }
+
+        const ResourceStats& ResourceCache::Stats()
+        {
+            ResourceCache& _instance = ResourceCache::instance();
+
+            return _instance.m_stats;
+        }
+
+        ResourceCache::Slot* ResourceCache::Lookup(ResourceHandle handle)
+        {
+            ResourceCache& _instance = ResourceCache::instance();
+
+            if (handle.index >= _instance.m_slots.size())
+                return nullptr;
+
+            Slot& slot = _instance.m_slots[handle.index];
+            if (slot.generation != handle.generation || slot.state == ResourceState::INVALID)
+                return nullptr;
+
+            return &slot;
+        }
+
+        bool ResourceCache::Request(uint32_t index)
+        {
+            ResourceCache& _instance = ResourceCache::instance();
+
+            uint64_t id = _instance.m_slots[index].id;
+            if (!AssetStreamer::Contains(id))
+                return false;
+
+            /*The streamer is at capacity; Update retries in order*/
+            if (!_instance.m_deferred.empty() ||
+                !AssetStreamer::Load(id, &ResourceCache::OnLoaded, reinterpret_cast<void*>(static_cast<uintptr_t>(index))))
+                _instance.m_deferred.push_back(index);
+
+            return true;
+        }
+
+        void ResourceCache::OnLoaded(StreamedAsset& asset, void* userData)
+        {
+            ResourceCache& _instance = ResourceCache::instance();
+
+            uint32_t index = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(userData));
+            if (index >= _instance.m_slots.size())
+                return;
+
+            Slot& slot = _instance.m_slots[index];
+            if (slot.state != ResourceState::LOADING || slot.id != asset.id)
+                return;
+
+            if (!asset.loaded)
+            {
+                slot.state = ResourceState::FAILED;
+                _instance.m_stats.failures++;
+                if (slot.refCount == 0)
+                    Evict(index);
+                return;
+            }
+
+            /*Moving the vector keeps its storage, so asset.data stays valid*/
+            slot.buffer = std::move(asset.buffer);
+            slot.data = asset.data;
+            slot.size = asset.size;
+            slot.state = ResourceState::READY;
+
+            ResourceStats& stats = _instance.m_stats;
+            stats.resident++;
+            stats.residentBytes += slot.size;
+            stats.peakBytes = std::max(stats.peakBytes, stats.residentBytes);
+
+            if (slot.refCount == 0)
+                LinkLRU(index);
+            Trim();
+        }
+
+        void ResourceCache::Unreferenced(uint32_t index)
+        {
+            ResourceCache& _instance = ResourceCache::instance();
+
+            /*Loading entries are linked when they finish; failed ones go now so a later Acquire retries*/
+            Slot& slot = _instance.m_slots[index];
+            if (slot.state == ResourceState::READY)
+            {
+                LinkLRU(index);
+                Trim();
+            }
+            else if (slot.state == ResourceState::FAILED)
+            {
+                Evict(index);
+            }
+        }
+
+        void ResourceCache::LinkLRU(uint32_t index)
+        {
+            ResourceCache& _instance = ResourceCache::instance();
+
+            /*Most recently released at the tail, next to evict at the head*/
+            Slot& slot = _instance.m_slots[index];
+            slot.prev = _instance.m_lruTail;
+            slot.next = NONE;
+            if (_instance.m_lruTail != NONE)
+                _instance.m_slots[_instance.m_lruTail].next = index;
+            else
+                _instance.m_lruHead = index;
+            _instance.m_lruTail = index;
+        }
+
+        void ResourceCache::UnlinkLRU(uint32_t index)
+        {
+            ResourceCache& _instance = ResourceCache::instance();
+
+            Slot& slot = _instance.m_slots[index];
+            if (slot.prev != NONE)
+                _instance.m_slots[slot.prev].next = slot.next;
+            else
+                _instance.m_lruHead = slot.next;
+            if (slot.next != NONE)
+                _instance.m_slots[slot.next].prev = slot.prev;
+            else
+                _instance.m_lruTail = slot.prev;
+
+            slot.prev = NONE;
+            slot.next = NONE;
+        }
+
+        void ResourceCache::Evict(uint32_t index)
+        {
+            ResourceCache& _instance = ResourceCache::instance();
+
+            Slot& slot = _instance.m_slots[index];
+            if (slot.state == ResourceState::READY)
+            {
+                UnlinkLRU(index);
+                _instance.m_stats.resident--;
+                _instance.m_stats.residentBytes -= slot.size;
+                _instance.m_stats.evictions++;
+            }
+
+            std::vector<uint8_t>().swap(slot.buffer);
+            slot.data = nullptr;
+            slot.size = 0;
+            slot.state = ResourceState::INVALID;
+            slot.generation++;
+            _instance.m_lookup.erase(slot.id);
+            _instance.m_freeSlots.push_back(index);
+        }
+
+        void ResourceCache::Trim()
+        {
+            ResourceCache& _instance = ResourceCache::instance();
+
+            while (_instance.m_stats.residentBytes > _instance.m_stats.budgetBytes && _instance.m_lruHead != NONE)
+                Evict(_instance.m_lruHead);
+        }
+
+    }
+
+}
@@ -15,6 +15,9 @@
 #include <ht_sdlwindow.h>
 #include <ht_debug.h>
 #include <ht_time_singleton.h>
+#include <ht_eventbus_singleton.h>
+
+#include <cstdio>
 
 namespace Hatchit {
 
@@ -24,17 +27,32 @@ namespace Hatchit {
         {
             m_params = params;
             m_handle = nullptr;
+            m_glcontext = nullptr;
             m_nativeHandle = nullptr;
+            m_running = false;
+            m_visible = true;
+            m_focused = true;
+            m_wakeEvent = static_cast<Uint32>(-1);
+            m_displayedFPS = -1;
+            m_titleBuffer[0] = '\0';
         }
 
         SDLWindow::~SDLWindow()
         {
+            /*
+            * Only destroyed once the renderer is shut down and any render
+            * thread joined, so nothing else can still be using the context.
+            */
+            if (m_glcontext)
+                SDL_GL_DeleteContext(m_glcontext);
+            if (m_handle)
+                SDL_DestroyWindow(m_handle);
             SDL_Quit();
         }
 
         bool SDLWindow::VInitialize()
         {
-            if (SDL_Init(SDL_INIT_TIMER) != 0) {
+            if (SDL_Init(SDL_INIT_TIMER | SDL_INIT_GAMECONTROLLER) != 0) {
 #ifdef _DEBUG
                 Core::DebugPrintF("SDL Failed to Initialize. Exiting\n");
 #endif
@@ -52,7 +70,6 @@ namespace Hatchit {
 #ifdef _DEBUG
                 Core::DebugPrintF("Failed to create SDL_Window handle. Exiting.\n");
 #endif 
-                SDL_Quit();
                 return false;
             }
 
@@ -70,101 +87,281 @@ namespace Hatchit {
 #ifdef _DEBUG
                     Core::DebugPrintF("Failed to create SDL_GL_Context handle. Exiting.\n");
 #endif
-                    SDL_Quit();
                     return false;
                 }
             }
            
 
+            Uint32 flags = SDL_GetWindowFlags(m_handle);
+            m_visible = (flags & (SDL_WINDOW_HIDDEN | SDL_WINDOW_MINIMIZED)) == 0;
+            m_focused = (flags & SDL_WINDOW_INPUT_FOCUS) != 0;
+            m_wakeEvent = SDL_RegisterEvents(1);
             m_running = true;
 
             return true;
         }
 
-        void SDLWindow::VPollEvents()
+        static bool TranslateWindowEvent(const SDL_WindowEvent& sdlEvent, Event& event)
         {
-            SDL_Event event;
-            while (SDL_PollEvent(&event))
+            event.window.x = sdlEvent.data1;
+            event.window.y = sdlEvent.data2;
+
+            switch (sdlEvent.event)
             {
-                switch (event.type)
-                {
-                case SDL_QUIT:
-                    VClose();
-                    break;
+            case SDL_WINDOWEVENT_SHOWN:         event.type = EventType::WINDOW_SHOWN; break;
+            case SDL_WINDOWEVENT_HIDDEN:        event.type = EventType::WINDOW_HIDDEN; break;
+            case SDL_WINDOWEVENT_EXPOSED:       event.type = EventType::WINDOW_EXPOSED; break;
+            case SDL_WINDOWEVENT_MOVED:         event.type = EventType::WINDOW_MOVED; break;
+            case SDL_WINDOWEVENT_SIZE_CHANGED:  event.type = EventType::WINDOW_RESIZED; break;
+            case SDL_WINDOWEVENT_MINIMIZED:     event.type = EventType::WINDOW_MINIMIZED; break;
+            case SDL_WINDOWEVENT_MAXIMIZED:     event.type = EventType::WINDOW_MAXIMIZED; break;
+            case SDL_WINDOWEVENT_RESTORED:      event.type = EventType::WINDOW_RESTORED; break;
+            case SDL_WINDOWEVENT_ENTER:         event.type = EventType::WINDOW_MOUSE_ENTER; break;
+            case SDL_WINDOWEVENT_LEAVE:         event.type = EventType::WINDOW_MOUSE_LEAVE; break;
+            case SDL_WINDOWEVENT_FOCUS_GAINED:  event.type = EventType::WINDOW_FOCUS_GAINED; break;
+            case SDL_WINDOWEVENT_FOCUS_LOST:    event.type = EventType::WINDOW_FOCUS_LOST; break;
+            case SDL_WINDOWEVENT_CLOSE:         event.type = EventType::WINDOW_CLOSE; break;
 
-                case SDL_WINDOWEVENT:
-                {
+            /*SDL_WINDOWEVENT_RESIZED duplicates SIZE_CHANGED for user resizes*/
+            default:
+                return false;
+            }
+
+            return true;
+        }
+
+        static int16_t ClampRelative(int32_t value)
+        {
+            return static_cast<int16_t>(value < -32768 ? -32768 : (value > 32767 ? 32767 : value));
+        }
+
+        /*Translates an SDL event into an engine event. Returns false for events the engine ignores.*/
+        static bool TranslateEvent(const SDL_Event& sdlEvent, Event& event)
+        {
+            event.type = EventType::COUNT;
+            event.timestamp = sdlEvent.common.timestamp;
+
+            switch (sdlEvent.type)
+            {
+            case SDL_QUIT:
+                event.type = EventType::QUIT;
+                return true;
+
+            case SDL_WINDOWEVENT:
+                return TranslateWindowEvent(sdlEvent.window, event);
+
+            case SDL_KEYDOWN:
+            case SDL_KEYUP:
+                event.type = EventType::KEY;
+                event.key.scancode = static_cast<uint16_t>(sdlEvent.key.keysym.scancode);
+                event.key.modifiers = static_cast<uint16_t>(sdlEvent.key.keysym.mod);
+                event.key.down = (sdlEvent.type == SDL_KEYDOWN) ? 1 : 0;
+                event.key.repeat = sdlEvent.key.repeat;
+                return true;
+
+            case SDL_MOUSEMOTION:
+                event.type = EventType::MOUSE_MOTION;
+                event.mouse.x = sdlEvent.motion.x;
+                event.mouse.y = sdlEvent.motion.y;
+                event.mouse.dx = ClampRelative(sdlEvent.motion.xrel);
+                event.mouse.dy = ClampRelative(sdlEvent.motion.yrel);
+                event.mouse.button = 0;
+                event.mouse.clicks = 0;
+                event.mouse.down = 0;
+                return true;
+
+            case SDL_MOUSEBUTTONDOWN:
+            case SDL_MOUSEBUTTONUP:
+                event.type = EventType::MOUSE_BUTTON;
+                event.mouse.x = sdlEvent.button.x;
+                event.mouse.y = sdlEvent.button.y;
+                event.mouse.dx = 0;
+                event.mouse.dy = 0;
+                event.mouse.button = sdlEvent.button.button;
+                event.mouse.clicks = sdlEvent.button.clicks;
+                event.mouse.down = (sdlEvent.type == SDL_MOUSEBUTTONDOWN) ? 1 : 0;
+                return true;
+
+            case SDL_MOUSEWHEEL:
+                event.type = EventType::MOUSE_WHEEL;
+                event.mouse.x = 0;
+                event.mouse.y = 0;
+                event.mouse.dx = ClampRelative(sdlEvent.wheel.x);
+                event.mouse.dy = ClampRelative(sdlEvent.wheel.y);
+                event.mouse.button = 0;
+                event.mouse.clicks = 0;
+                event.mouse.down = 0;
+                return true;
+
+            case SDL_CONTROLLERDEVICEADDED:
+            case SDL_CONTROLLERDEVICEREMOVED:
+                event.type = (sdlEvent.type == SDL_CONTROLLERDEVICEADDED) ? EventType::CONTROLLER_ADDED : EventType::CONTROLLER_REMOVED;
+                event.controller.id = sdlEvent.cdevice.which;
+                event.controller.control = 0;
+                event.controller.value = 0;
+                return true;
+
+            case SDL_CONTROLLERBUTTONDOWN:
+            case SDL_CONTROLLERBUTTONUP:
+                event.type = EventType::CONTROLLER_BUTTON;
+                event.controller.id = sdlEvent.cbutton.which;
+                event.controller.control = sdlEvent.cbutton.button;
+                event.controller.value = (sdlEvent.type == SDL_CONTROLLERBUTTONDOWN) ? 1 : 0;
+                return true;
+
+            case SDL_CONTROLLERAXISMOTION:
+                event.type = EventType::CONTROLLER_AXIS;
+                event.controller.id = sdlEvent.caxis.which;
+                event.controller.control = sdlEvent.caxis.axis;
+                event.controller.value = sdlEvent.caxis.value;
+                return true;
+
+            default:
+                return false;
+            }
+        }
+
+#ifdef _DEBUG
+        static void LogWindowEvent(const SDL_WindowEvent& event)
+        {
+            switch (event.event)
+            {
+            case SDL_WINDOWEVENT_SHOWN:
+                SDL_Log("Window %d shown", event.windowID);
+                break;
+            case SDL_WINDOWEVENT_HIDDEN:
+                SDL_Log("Window %d hidden", event.windowID);
+                break;
+            case SDL_WINDOWEVENT_EXPOSED:
+                SDL_Log("Window %d exposed", event.windowID);
+                break;
+            case SDL_WINDOWEVENT_MOVED:
+                SDL_Log("Window %d moved to %d,%d",
+                    event.windowID, event.data1,
+                    event.data2);
+                break;
+            case SDL_WINDOWEVENT_RESIZED:
+                SDL_Log("Window %d resized to %dx%d",
+                    event.windowID, event.data1,
+                    event.data2);
+                break;
+            case SDL_WINDOWEVENT_SIZE_CHANGED:
+                SDL_Log("Window %d size changed to %dx%d",
+                    event.windowID, event.data1,
+                    event.data2);
+                break;
+            case SDL_WINDOWEVENT_MINIMIZED:
+                SDL_Log("Window %d minimized", event.windowID);
+                break;
+            case SDL_WINDOWEVENT_MAXIMIZED:
+                SDL_Log("Window %d maximized", event.windowID);
+                break;
+            case SDL_WINDOWEVENT_RESTORED:
+                SDL_Log("Window %d restored", event.windowID);
+                break;
+            case SDL_WINDOWEVENT_ENTER:
+                SDL_Log("Mouse entered window %d",
+                    event.windowID);
+                break;
+            case SDL_WINDOWEVENT_LEAVE:
+                SDL_Log("Mouse left window %d", event.windowID);
+                break;
+            case SDL_WINDOWEVENT_FOCUS_GAINED:
+                SDL_Log("Window %d gained keyboard focus",
+                    event.windowID);
+                break;
+            case SDL_WINDOWEVENT_FOCUS_LOST:
+                SDL_Log("Window %d lost keyboard focus",
+                    event.windowID);
+                break;
+            case SDL_WINDOWEVENT_CLOSE:
+                SDL_Log("Window %d closed", event.windowID);
+                break;
+            default:
+                SDL_Log("Window %d got unknown event %d",
+                    event.windowID, event.event);
+            }
+        }
+#endif
+
+        void SDLWindow::HandleEvent(const SDL_Event& sdlEvent)
+        {
 #ifdef _DEBUG
-                    if (m_params.debugWindowEvents)
-                    {
-                        switch (event.window.event)
-                        {
-                        case SDL_WINDOWEVENT_SHOWN:
-                            SDL_Log("Window %d shown", event.window.windowID);
-                            break;
-                        case SDL_WINDOWEVENT_HIDDEN:
-                            SDL_Log("Window %d hidden", event.window.windowID);
-                            break;
-                        case SDL_WINDOWEVENT_EXPOSED:
-                            SDL_Log("Window %d exposed", event.window.windowID);
-                            break;
-                        case SDL_WINDOWEVENT_MOVED:
-                            SDL_Log("Window %d moved to %d,%d",
-                                event.window.windowID, event.window.data1,
-                                event.window.data2);
-                            break;
-                        case SDL_WINDOWEVENT_RESIZED:
-                            SDL_Log("Window %d resized to %dx%d",
-                                event.window.windowID, event.window.data1,
-                                event.window.data2);
-                            break;
-                        case SDL_WINDOWEVENT_SIZE_CHANGED:
-                            SDL_Log("Window %d size changed to %dx%d",
-                                event.window.windowID, event.window.data1,
-                                event.window.data2);
-                            break;
-                        case SDL_WINDOWEVENT_MINIMIZED:
-                            SDL_Log("Window %d minimized", event.window.windowID);
-                            break;
-                        case SDL_WINDOWEVENT_MAXIMIZED:
-                            SDL_Log("Window %d maximized", event.window.windowID);
-                            break;
-                        case SDL_WINDOWEVENT_RESTORED:
-                            SDL_Log("Window %d restored", event.window.windowID);
-                            break;
-                        case SDL_WINDOWEVENT_ENTER:
-                            SDL_Log("Mouse entered window %d",
-                                event.window.windowID);
-                            break;
-                        case SDL_WINDOWEVENT_LEAVE:
-                            SDL_Log("Mouse left window %d", event.window.windowID);
-                            break;
-                        case SDL_WINDOWEVENT_FOCUS_GAINED:
-                            SDL_Log("Window %d gained keyboard focus",
-                                event.window.windowID);
-                            break;
-                        case SDL_WINDOWEVENT_FOCUS_LOST:
-                            SDL_Log("Window %d lost keyboard focus",
-                                event.window.windowID);
-                            break;
-                        case SDL_WINDOWEVENT_CLOSE:
-                            SDL_Log("Window %d closed", event.window.windowID);
-                            break;
-                        default:
-                            SDL_Log("Window %d got unknown event %d",
-                                event.window.windowID, event.window.event);
-                        }
-                    }
+            if (m_params.debugWindowEvents && sdlEvent.type == SDL_WINDOWEVENT)
+                LogWindowEvent(sdlEvent.window);
 #endif
-                } break;
+            Event event;
+            if (TranslateEvent(sdlEvent, event))
+            {
+                /*
+                * ADDED carries a device index, everything after it the joystick
+                * instance id, so publish the instance id of the opened controller.
+                */
+                if (event.type == EventType::CONTROLLER_ADDED)
+                {
+                    SDL_GameController* controller = SDL_GameControllerOpen(sdlEvent.cdevice.which);
+                    if (!controller)
+                        return;
+                    event.controller.id = SDL_JoystickInstanceID(SDL_GameControllerGetJoystick(controller));
+                }
 
-                default:
-                    break;
+                TrackWindowState(event);
+                EventBus::Publish(event);
+
+                if (event.type == EventType::CONTROLLER_REMOVED)
+                {
+                    SDL_GameController* controller = SDL_GameControllerFromInstanceID(sdlEvent.cdevice.which);
+                    if (controller)
+                        SDL_GameControllerClose(controller);
                 }
             }
 
+            if (sdlEvent.type == SDL_QUIT)
+                VClose();
+        }
+
+        void SDLWindow::VPollEvents()
+        {
+            SDL_Event sdlEvent;
+            while (SDL_PollEvent(&sdlEvent))
+                HandleEvent(sdlEvent);
+
+            /*Only touch the title when the value changes; this runs every frame*/
             if (m_params.displayFPS)
-                SDL_SetWindowTitle(m_handle, (m_params.title + " FPS: " + std::to_string((int)Time::FramesPerSecond())).c_str());
+            {
+                int fps = static_cast<int>(Time::FramesPerSecond());
+                if (fps != m_displayedFPS)
+                {
+                    m_displayedFPS = fps;
+                    std::snprintf(m_titleBuffer, sizeof(m_titleBuffer), "%s FPS: %d", m_params.title.c_str(), fps);
+                    SDL_SetWindowTitle(m_handle, m_titleBuffer);
+                }
+            }
+        }
+
+        bool SDLWindow::VWaitEvents(uint32_t timeoutMs)
+        {
+            /*Blocks in the OS until input, a window event or VWake arrives*/
+            SDL_Event sdlEvent;
+            if (!SDL_WaitEventTimeout(&sdlEvent, static_cast<int>(timeoutMs)))
+                return false;
+
+            HandleEvent(sdlEvent);
+            VPollEvents();
+
+            return true;
+        }
+
+        void SDLWindow::VWake()
+        {
+            if (m_wakeEvent == static_cast<Uint32>(-1))
+                return;
+
+            /*SDL_PushEvent is thread-safe; the event itself is dropped by TranslateEvent*/
+            SDL_Event sdlEvent;
+            SDL_memset(&sdlEvent, 0, sizeof(sdlEvent));
+            sdlEvent.type = m_wakeEvent;
+            SDL_PushEvent(&sdlEvent);
         }
 
         void* SDLWindow::VNativeHandle()
@@ -179,9 +376,8 @@ namespace Hatchit {
 
         void SDLWindow::VClose()
         {
+            /*The loop ends on its own; the context and window go in the destructor*/
             m_running = false;
-            SDL_GL_DeleteContext(m_glcontext);
-            SDL_Quit();
         }
 
         void SDLWindow::VSwapBuffers()
@@ -189,6 +385,62 @@ namespace Hatchit {
             if (m_params.renderer == Graphics::RendererType::OPENGL)
                 SDL_GL_SwapWindow(m_handle);
         }
+
+        void SDLWindow::VMakeContextCurrent(bool current)
+        {
+            if (m_params.renderer == Graphics::RendererType::OPENGL)
+                SDL_GL_MakeCurrent(m_handle, current ? m_glcontext : nullptr);
+        }
+
+        bool SDLWindow::VIsVisible()
+        {
+            return m_visible;
+        }
+
+        bool SDLWindow::VHasFocus()
+        {
+            return m_focused;
+        }
+
+        void SDLWindow::VSetDisplayFPS(bool display)
+        {
+            if (display == m_params.displayFPS)
+                return;
+
+            m_params.displayFPS = display;
+            m_displayedFPS = -1;
+            if (!display && m_handle)
+                SDL_SetWindowTitle(m_handle, m_params.title.c_str());
+        }
+
+        void SDLWindow::TrackWindowState(const Event& event)
+        {
+            switch (event.type)
+            {
+            case EventType::WINDOW_SHOWN:
+            case EventType::WINDOW_EXPOSED:
+            case EventType::WINDOW_RESTORED:
+            case EventType::WINDOW_MAXIMIZED:
+                m_visible = true;
+                break;
+
+            case EventType::WINDOW_HIDDEN:
+            case EventType::WINDOW_MINIMIZED:
+                m_visible = false;
+                break;
+
+            case EventType::WINDOW_FOCUS_GAINED:
+                m_focused = true;
+                break;
+
+            case EventType::WINDOW_FOCUS_LOST:
+                m_focused = false;
+                break;
+
+            default:
+                break;
+            }
+        }
     }
 
 }
\ No newline at end of file
@@ -0,0 +1,416 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+
+#include <ht_settings_singleton.h>
+#include <ht_file.h>
+#include <ht_debug.h>
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <fstream>
+
+#ifdef HT_SYS_LINUX
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace Hatchit {
+
+    namespace Game {
+
+        using namespace Graphics;
+
+        Settings::Settings()
+        {
+            m_current = nullptr;
+            m_collected = nullptr;
+            m_stopping = false;
+        }
+
+        /*Section names in file order; false if the file can't be read*/
+        static bool ReadSections(const std::string& path, std::vector<std::string>& sections)
+        {
+            std::ifstream file(path.c_str());
+            if (!file)
+                return false;
+
+            sections.clear();
+            std::string line;
+            while (std::getline(file, line))
+            {
+                size_t begin = line.find_first_not_of(" \t");
+                if (begin == std::string::npos || line[begin] != '[')
+                    continue;
+
+                size_t end = line.find(']', begin);
+                if (end != std::string::npos)
+                    sections.push_back(line.substr(begin + 1, end - begin - 1));
+            }
+
+            return true;
+        }
+
+        bool Settings::Initialize(Core::INIReader* reader, const std::string& path)
+        {
+            Settings& _instance = Settings::instance();
+
+            SettingsSnapshot* snapshot = new SettingsSnapshot;
+            Build(reader, *snapshot);
+            snapshot->version = 1;
+            Publish(snapshot);
+
+            _instance.m_path = path;
+            if (!path.empty() && snapshot->hotReload)
+            {
+                /*Reloads must still have these, which rules out empty and partly written files*/
+                ReadSections(path, _instance.m_sections);
+
+                _instance.m_stopping = false;
+                _instance.m_watcher = std::thread(&Settings::WatchMain);
+            }
+
+            return true;
+        }
+
+        void Settings::DeInitialize()
+        {
+            Settings& _instance = Settings::instance();
+
+            if (_instance.m_watcher.joinable())
+            {
+                _instance.m_stopping = true;
+                _instance.m_watcher.join();
+            }
+
+            _instance.m_current = nullptr;
+            _instance.m_collected = nullptr;
+            for (size_t i = 0; i < _instance.m_snapshots.size(); i++)
+                delete _instance.m_snapshots[i];
+            _instance.m_snapshots.clear();
+        }
+
+        void Settings::Collect()
+        {
+            Settings& _instance = Settings::instance();
+
+            /*Nothing published since the last call: skip the lock*/
+            const SettingsSnapshot* current = _instance.m_current.load(std::memory_order_acquire);
+            if (current == _instance.m_collected)
+                return;
+
+            std::lock_guard<std::mutex> lock(_instance.m_lock);
+
+            /*
+            * The newest entry is current. The one before it may still be in a
+            * reader's hands from the frame that just ended; anything older
+            * was replaced at least a frame ago and is no longer referenced.
+            */
+            size_t retained = std::min<size_t>(_instance.m_snapshots.size(), 2);
+            size_t stale = _instance.m_snapshots.size() - retained;
+            for (size_t i = 0; i < stale; i++)
+                delete _instance.m_snapshots[i];
+            _instance.m_snapshots.erase(_instance.m_snapshots.begin(), _instance.m_snapshots.begin() + stale);
+
+            _instance.m_collected = _instance.m_snapshots.empty() ? nullptr : _instance.m_snapshots.back();
+        }
+
+        const SettingsSnapshot& Settings::Current()
+        {
+            Settings& _instance = Settings::instance();
+
+            return *_instance.m_current.load(std::memory_order_acquire);
+        }
+
+        bool Settings::Reload()
+        {
+            Settings& _instance = Settings::instance();
+
+            /*A half-written or unreadable file keeps the current snapshot*/
+            std::vector<std::string> sections;
+            bool complete = ReadSections(_instance.m_path, sections) && !sections.empty();
+            for (size_t i = 0; complete && i < _instance.m_sections.size(); i++)
+                complete = std::find(sections.begin(), sections.end(), _instance.m_sections[i]) != sections.end();
+            if (!complete)
+            {
+#ifdef _DEBUG
+                Core::DebugPrintF("Ignoring incomplete settings file %s\n", _instance.m_path.c_str());
+#endif
+                return false;
+            }
+
+            Core::INIReader reader;
+            try
+            {
+                Core::File file;
+                file.Open(_instance.m_path, Core::FileMode::ReadText);
+                reader.Load(&file);
+            }
+            catch (const std::exception&)
+            {
+#ifdef _DEBUG
+                Core::DebugPrintF("Failed to reload settings from %s\n", _instance.m_path.c_str());
+#endif
+                return false;
+            }
+
+            SettingsSnapshot* snapshot = new SettingsSnapshot;
+            Build(&reader, *snapshot);
+            snapshot->version = Current().version + 1;
+            Publish(snapshot);
+
+#ifdef _DEBUG
+            Core::DebugPrintF("Settings reloaded from %s (version %u)\n", _instance.m_path.c_str(), snapshot->version);
+#endif
+
+            return true;
+        }
+
+        void Settings::Build(Core::INIReader* reader, SettingsSnapshot& snapshot)
+        {
+            snapshot.version = 0;
+
+            /*Per-frame scratch memory, double buffered*/
+            int arenaKB = reader->GetValue("MEMORY", "iFrameArenaKB", 1024);
+            snapshot.frameArenaBytes = static_cast<size_t>(arenaKB > 0 ? arenaKB : 1024) * 1024;
+
+            /*Worker threads besides the main thread; -1 uses every hardware thread*/
+            snapshot.workerCount = reader->GetValue("JOBS", "iWorkerCount", -1);
+
+            /*Per-frame event buffer capacity before it has to grow*/
+            int eventCapacity = reader->GetValue("EVENTS", "iCapacity", 1024);
+            snapshot.eventCapacity = eventCapacity > 0 ? static_cast<uint32_t>(eventCapacity) : 1024;
+
+            /*Configure fixed-rate simulation loop*/
+            int updateRate = reader->GetValue("LOOP", "iUpdateRate", 60);
+            int maxUpdateSteps = reader->GetValue("LOOP", "iMaxUpdateSteps", 5);
+            snapshot.updateRate = updateRate > 0 ? static_cast<uint32_t>(updateRate) : 60;
+            snapshot.maxUpdateSteps = maxUpdateSteps > 0 ? static_cast<uint32_t>(maxUpdateSteps) : 1;
+
+            /*Frame-rate cap: sleep most of the remaining time, spin the last iSpinMicroseconds*/
+            snapshot.targetFPS = std::max(reader->GetValue("LOOP", "fTargetFPS", 0.0f), 0.0f);
+            snapshot.spinMicroseconds = static_cast<uint32_t>(std::max(reader->GetValue("LOOP", "iSpinMicroseconds", 1000), 0));
+            std::string pacing = reader->GetValue("LOOP", "sPacing", std::string("FIXED"));
+            snapshot.pacing = (pacing == "PRESENT" || pacing == "present") ? PacingMode::PRESENT : PacingMode::FIXED;
+
+            /*Tick rate while hidden or minimized; bThrottleUnfocused also applies it without focus*/
+            snapshot.backgroundFPS = reader->GetValue("LOOP", "fBackgroundFPS", 10.0f);
+            if (snapshot.backgroundFPS <= 0.0f)
+                snapshot.backgroundFPS = 10.0f;
+            snapshot.throttleUnfocused = reader->GetValue("LOOP", "bThrottleUnfocused", false);
+
+            /*EVENT mode (tools, editors) blocks between frames; iEventTimeoutMs bounds the simulation gap*/
+            std::string mode = reader->GetValue("LOOP", "sMode", std::string("CONTINUOUS"));
+            snapshot.eventDriven = (mode == "EVENT" || mode == "event");
+            snapshot.eventTimeoutMs = static_cast<uint32_t>(std::max(reader->GetValue("LOOP", "iEventTimeoutMs", 250), 1));
+
+            /*Frames allowed to allocate while caches warm up before the allocation guard arms*/
+            int warmupFrames = reader->GetValue("LOOP", "iAllocationWarmupFrames", 60);
+            snapshot.allocationWarmupFrames = warmupFrames > 0 ? static_cast<uint32_t>(warmupFrames) : 0;
+            snapshot.assertNoFrameAllocations = reader->GetValue("LOOP", "bAssertNoFrameAllocations", false);
+            snapshot.frameStats = reader->GetValue("LOOP", "bFrameStats", false);
+
+            /*Window values*/
+            WindowParams& window = snapshot.window;
+            window.title = reader->GetValue("WINDOW", "sTitle", std::string("Hatchit Engine"));
+            window.x = reader->GetValue("WINDOW", "iX", -1);
+            window.y = reader->GetValue("WINDOW", "iY", -1);
+            window.width = reader->GetValue("WINDOW", "iWidth", 800);
+            window.height = reader->GetValue("WINDOW", "iHeight", 600);
+            window.displayFPS = reader->GetValue("WINDOW", "bFPS", false);
+            window.debugWindowEvents = reader->GetValue("WINDOW", "bDebugWindowEvents", false);
+
+            /*sBackend=null runs without a display or GPU, for iFrameCount frames (0 = until closed)*/
+            std::string backend = reader->GetValue("WINDOW", "sBackend", std::string("SDL"));
+            window.backend = (backend == "null" || backend == "NULL") ? WindowBackend::HEADLESS : WindowBackend::SDL;
+            int frameCount = reader->GetValue("WINDOW", "iFrameCount", 0);
+            window.frameCount = frameCount > 0 ? static_cast<uint32_t>(frameCount) : 0;
+
+            /*Renderer values*/
+#ifdef HT_SYS_LINUX
+            window.renderer = RendererType::OPENGL;
+#else
+            std::string renderer = reader->GetValue("RENDERER", "sRenderer", std::string("DIRECTX"));
+            window.renderer = (renderer == "DIRECTX") ? RendererType::DIRECTX : RendererType::OPENGL;
+#endif
+            snapshot.clearColor[0] = reader->GetValue("RENDERER", "fClearR", 0.0f);
+            snapshot.clearColor[1] = reader->GetValue("RENDERER", "fClearG", 0.0f);
+            snapshot.clearColor[2] = reader->GetValue("RENDERER", "fClearB", 0.0f);
+            snapshot.clearColor[3] = reader->GetValue("RENDERER", "fClearA", 0.0f);
+
+            /*Optional render thread, so simulation of frame N+1 overlaps submission of frame N*/
+            snapshot.threaded = reader->GetValue("RENDERER", "bThreaded", false);
+            snapshot.framesInFlight = static_cast<uint32_t>(std::max(reader->GetValue("RENDERER", "iFramesInFlight", 2), 1));
+
+            /*
+            * Size changes are coalesced to one ResizeBuffers per frame, issued
+            * once no new size has arrived for iResizeDebounceMs (0 = next frame).
+            */
+            snapshot.resizeDebounceMs = static_cast<uint32_t>(std::max(reader->GetValue("RENDERER", "iResizeDebounceMs", 100), 0));
+
+            /*
+            * Loose grid for spatial queries, centered on fCenterX/Y/Z. Objects
+            * wider than fCellSize are kept on a list checked by every query.
+            */
+            BroadphaseParams& broadphase = snapshot.broadphase;
+            broadphase.cellSize = reader->GetValue("BROADPHASE", "fCellSize", 4.0f);
+            if (!(broadphase.cellSize > 0.0f))
+                broadphase.cellSize = 4.0f;
+            static const char* cellKeys[3] = { "iCellsX", "iCellsY", "iCellsZ" };
+            static const char* centerKeys[3] = { "fCenterX", "fCenterY", "fCenterZ" };
+            uint64_t cellCount = 1;
+            for (uint32_t a = 0; a < 3; a++)
+            {
+                broadphase.cells[a] = static_cast<uint32_t>(std::max(reader->GetValue("BROADPHASE", cellKeys[a], 64), 1));
+                cellCount *= broadphase.cells[a];
+            }
+            for (uint32_t a = 0; a < 3; a++)
+            {
+                if (cellCount > Broadphase::MAX_CELLS)
+                    broadphase.cells[a] = 64;
+                float center = reader->GetValue("BROADPHASE", centerKeys[a], 0.0f);
+                broadphase.origin[a] = center - broadphase.cells[a] * broadphase.cellSize * 0.5f;
+            }
+
+            /*
+            * Packs to mount at startup, separated by ';', later ones shadowing
+            * earlier ones. Finished loads are handed to their callbacks for at
+            * most iDispatchBudgetUs per frame.
+            */
+            std::string packs = reader->GetValue("STREAMING", "sPacks", std::string(""));
+            snapshot.packs.clear();
+            for (size_t begin = 0; begin < packs.size();)
+            {
+                size_t end = std::min(packs.find(';', begin), packs.size());
+                if (end > begin)
+                    snapshot.packs.push_back(packs.substr(begin, end - begin));
+                begin = end + 1;
+            }
+            snapshot.streamingThreads = static_cast<uint32_t>(std::max(reader->GetValue("STREAMING", "iThreads", 1), 1));
+            snapshot.streamingCapacity = static_cast<uint32_t>(std::max(reader->GetValue("STREAMING", "iCapacity", 256), 1));
+            snapshot.streamingBudgetUs = static_cast<uint32_t>(std::max(reader->GetValue("STREAMING", "iDispatchBudgetUs", 1000), 0));
+
+            /*Unreferenced resources are evicted once the cache holds more than this*/
+            snapshot.resourceBudgetBytes = static_cast<size_t>(std::max(reader->GetValue("RESOURCES", "iBudgetMB", 256), 0)) << 20;
+
+            /*Written once the first frame is out; empty disables the report*/
+            snapshot.startupReport = reader->GetValue("STARTUP", "sReport", std::string(""));
+            snapshot.printStartup = reader->GetValue("STARTUP", "bPrint", false);
+
+            /*
+            * sMode=record writes this run's frame deltas and window input to
+            * sPath; sMode=play feeds them back headless and unpaced instead.
+            */
+            std::string replay = reader->GetValue("REPLAY", "sMode", std::string("off"));
+            if (replay == "record" || replay == "RECORD")
+                snapshot.replayMode = ReplayMode::RECORD;
+            else if (replay == "play" || replay == "PLAY")
+                snapshot.replayMode = ReplayMode::PLAY;
+            else
+                snapshot.replayMode = ReplayMode::OFF;
+            snapshot.replayPath = reader->GetValue("REPLAY", "sPath", std::string("replay.bin"));
+
+            /*Watch the settings file and republish on change*/
+            snapshot.hotReload = reader->GetValue("SETTINGS", "bHotReload", true);
+        }
+
+        void Settings::Publish(SettingsSnapshot* snapshot)
+        {
+            Settings& _instance = Settings::instance();
+
+            std::lock_guard<std::mutex> lock(_instance.m_lock);
+
+            /*Readers may still hold the previous snapshot, so it is retired here and freed by Collect*/
+            _instance.m_snapshots.push_back(snapshot);
+            _instance.m_current.store(snapshot, std::memory_order_release);
+        }
+
+#ifdef HT_SYS_LINUX
+        void Settings::WatchMain()
+        {
+            Settings& _instance = Settings::instance();
+
+            /*Watch the directory: editors often replace the file instead of rewriting it*/
+            size_t slash = _instance.m_path.find_last_of('/');
+            std::string directory = (slash == std::string::npos) ? std::string(".") : _instance.m_path.substr(0, slash);
+            std::string name = (slash == std::string::npos) ? _instance.m_path : _instance.m_path.substr(slash + 1);
+
+            int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if (fd < 0 || inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+            {
+#ifdef _DEBUG
+                Core::DebugPrintF("Failed to watch %s for settings changes\n", _instance.m_path.c_str());
+#endif
+                if (fd >= 0)
+                    close(fd);
+                return;
+            }
+
+            alignas(inotify_event) char buffer[4096];
+            while (!_instance.m_stopping)
+            {
+                pollfd descriptor;
+                descriptor.fd = fd;
+                descriptor.events = POLLIN;
+                descriptor.revents = 0;
+                if (poll(&descriptor, 1, 200) <= 0)
+                    continue;
+
+                bool changed = false;
+                ssize_t length;
+                while ((length = read(fd, buffer, sizeof(buffer))) > 0)
+                {
+                    for (char* cursor = buffer; cursor < buffer + length; )
+                    {
+                        const inotify_event* event = reinterpret_cast<const inotify_event*>(cursor);
+                        if (event->len > 0 && name == event->name)
+                            changed = true;
+                        cursor += sizeof(inotify_event) + event->len;
+                    }
+                }
+
+                if (changed)
+                    Reload();
+            }
+
+            close(fd);
+        }
+#else
+        void Settings::WatchMain()
+        {
+            Settings& _instance = Settings::instance();
+
+            /*No inotify here: poll the modification time instead*/
+            struct stat info;
+            time_t modified = (stat(_instance.m_path.c_str(), &info) == 0) ? info.st_mtime : 0;
+            while (!_instance.m_stopping)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+                if (stat(_instance.m_path.c_str(), &info) != 0 || info.st_mtime == modified)
+                    continue;
+
+                modified = info.st_mtime;
+                Reload();
+            }
+        }
+#endif
+
+    }
+
+}
@@ -0,0 +1,140 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+
+#include <ht_startup_trace.h>
+#include <ht_time_singleton.h>
+#include <ht_debug.h>
+
+#include <cstdio>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        StartupTrace::StartupTrace()
+        {
+            m_count = 0;
+            m_start = 0;
+            m_end = 0;
+        }
+
+        void StartupTrace::Start()
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+
+            m_count = 0;
+            m_start = Time::Ticks();
+            m_end = m_start;
+            m_mainThread = std::this_thread::get_id();
+        }
+
+        uint32_t StartupTrace::BeginPhase(const char* name)
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+
+            if (m_count == MAX_PHASES)
+                return MAX_PHASES;
+
+            Phase& phase = m_phases[m_count];
+            phase.name = name;
+            phase.start = Time::Ticks();
+            phase.end = phase.start;
+            phase.mainThread = (std::this_thread::get_id() == m_mainThread);
+
+            return m_count++;
+        }
+
+        void StartupTrace::EndPhase(uint32_t phase)
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+
+            if (phase < m_count)
+                m_phases[phase].end = Time::Ticks();
+        }
+
+        void StartupTrace::Finish()
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+
+            m_end = Time::Ticks();
+        }
+
+        uint64_t StartupTrace::TotalTicks() const
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+
+            return m_end - m_start;
+        }
+
+        bool StartupTrace::Write(const std::string& path) const
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+
+            std::FILE* file = std::fopen(path.c_str(), "w");
+            if (!file)
+            {
+#ifdef _DEBUG
+                Core::DebugPrintF("Failed to write startup report to %s\n", path.c_str());
+#endif
+                return false;
+            }
+
+            std::fprintf(file, "startup %.3f ms\n", Time::TicksToSeconds(m_end - m_start) * 1000.0);
+            std::fprintf(file, "%-16s %-8s %12s %12s\n", "phase", "thread", "start ms", "duration ms");
+            for (uint32_t i = 0; i < m_count; i++)
+            {
+                const Phase& phase = m_phases[i];
+                std::fprintf(file, "%-16s %-8s %12.3f %12.3f\n",
+                    phase.name,
+                    phase.mainThread ? "main" : "worker",
+                    Time::TicksToSeconds(phase.start - m_start) * 1000.0,
+                    Time::TicksToSeconds(phase.end - phase.start) * 1000.0);
+            }
+
+            std::fclose(file);
+
+            return true;
+        }
+
+        void StartupTrace::Dump() const
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+
+            Core::DebugPrintF("Startup took %.3f ms\n", Time::TicksToSeconds(m_end - m_start) * 1000.0);
+            for (uint32_t i = 0; i < m_count; i++)
+            {
+                const Phase& phase = m_phases[i];
+                Core::DebugPrintF("    %-16s %-6s at %8.3f ms for %8.3f ms\n",
+                    phase.name,
+                    phase.mainThread ? "main" : "worker",
+                    Time::TicksToSeconds(phase.start - m_start) * 1000.0,
+                    Time::TicksToSeconds(phase.end - phase.start) * 1000.0);
+            }
+        }
+
+        ScopedStartupPhase::ScopedStartupPhase(StartupTrace& trace, const char* name)
+            : m_trace(trace)
+        {
+            m_phase = m_trace.BeginPhase(name);
+        }
+
+        ScopedStartupPhase::~ScopedStartupPhase()
+        {
+            m_trace.EndPhase(m_phase);
+        }
+
+    }
+
+}
@@ -14,50 +14,87 @@
 
 #include <ht_time_singleton.h>
 
+#include <chrono>
+
 namespace Hatchit {
 
     namespace Game {
 
         Time::Time()
         {
-            m_timer = new Core::Timer;
+            m_startTick = 0;
+            m_currentTick = 0;
+            m_deltaTicks = 0;
+            m_frameIndex = 0;
+            m_fpsWindowStart = 0;
+            m_fpsFrameCount = 0;
             m_fps = 0.0f;
             m_mspf = 0.0f;
+            m_fixedStep = TICKS_PER_SECOND / 60;
+            m_accumulator = 0;
+            m_alpha = 0.0f;
+            m_maxSteps = 5;
+            m_steps = 0;
         }
 
         void Time::Start()
         {
             Time& _instance = Time::instance();
 
-            _instance.m_timer->Reset();
-            _instance.m_timer->Start();
+            _instance.m_startTick = Ticks();
+            _instance.m_currentTick = _instance.m_startTick;
+            _instance.m_deltaTicks = 0;
+            _instance.m_frameIndex = 0;
+            _instance.m_fpsWindowStart = _instance.m_startTick;
+            _instance.m_fpsFrameCount = 0;
+            _instance.m_fps = 0.0f;
+            _instance.m_mspf = 0.0f;
+
+            _instance.m_accumulator = 0;
+            _instance.m_alpha = 0.0f;
+            _instance.m_steps = 0;
+            _instance.m_profiler.Reset();
+            _instance.m_pacer.Reset();
         }
 
         void Time::Tick()
         {
             Time& _instance = Time::instance();
 
-            _instance.m_timer->Tick();
+            Tick(Ticks() - _instance.m_currentTick);
         }
 
-        void Time::CalculateFPS()
+        void Time::Tick(uint64_t deltaTicks)
         {
             Time& _instance = Time::instance();
 
-            static int frameCnt = 0;
-            static float timeElapsed = 0.0f;
+            _instance.m_deltaTicks = deltaTicks;
+            _instance.m_currentTick += deltaTicks;
+            _instance.m_frameIndex++;
+
+            /*Frame timings stay on the real clock, so a replay still measures this run*/
+            _instance.m_profiler.BeginFrame(Ticks());
 
-            frameCnt++;
+            _instance.m_accumulator += _instance.m_deltaTicks;
+            _instance.m_steps = 0;
+        }
+
+        void Time::CalculateFPS()
+        {
+            Time& _instance = Time::instance();
+
+            _instance.m_fpsFrameCount++;
 
             // Compute averages over one second period.
-            if ((_instance.TotalTime() - timeElapsed) >= 1.0f)
+            uint64_t elapsed = _instance.m_currentTick - _instance.m_fpsWindowStart;
+            if (elapsed >= TICKS_PER_SECOND)
             {
-                _instance.m_fps = static_cast<float>(frameCnt);
+                _instance.m_fps = static_cast<float>(_instance.m_fpsFrameCount / TicksToSeconds(elapsed));
                 _instance.m_mspf = 1000.0f / _instance.m_fps;
 
                 // Reset for next average.
-                frameCnt = 0;
-                timeElapsed += 1.0f;
+                _instance.m_fpsFrameCount = 0;
+                _instance.m_fpsWindowStart = _instance.m_currentTick;
             }
         }
 
@@ -65,7 +102,7 @@ namespace Hatchit {
         {
             Time& _instance = Time::instance();
 
-            return _instance.m_timer->DeltaTime();
+            return static_cast<float>(TicksToSeconds(_instance.m_deltaTicks));
         }
 
         float Time::FramesPerSecond()
@@ -83,11 +120,181 @@ namespace Hatchit {
         }
 
         float Time::TotalTime()
+        {
+            return static_cast<float>(TicksToSeconds(TotalTicks()));
+        }
+
+        uint64_t Time::Ticks()
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        uint64_t Time::DeltaTicks()
+        {
+            Time& _instance = Time::instance();
+
+            return _instance.m_deltaTicks;
+        }
+
+        uint64_t Time::TotalTicks()
+        {
+            Time& _instance = Time::instance();
+
+            return _instance.m_currentTick - _instance.m_startTick;
+        }
+
+        uint64_t Time::FrameIndex()
+        {
+            Time& _instance = Time::instance();
+
+            return _instance.m_frameIndex;
+        }
+
+        double Time::TicksToSeconds(uint64_t ticks)
+        {
+            return static_cast<double>(ticks) / static_cast<double>(TICKS_PER_SECOND);
+        }
+
+        uint64_t Time::SecondsToTicks(double seconds)
+        {
+            return static_cast<uint64_t>(seconds * static_cast<double>(TICKS_PER_SECOND));
+        }
+
+        void Time::SetFixedTimeStep(float step, uint32_t maxStepsPerFrame)
+        {
+            Time& _instance = Time::instance();
+
+            _instance.m_fixedStep = SecondsToTicks(step);
+            if (_instance.m_fixedStep == 0)
+                _instance.m_fixedStep = 1;
+            _instance.m_maxSteps = maxStepsPerFrame;
+        }
+
+        bool Time::ConsumeFixedStep()
+        {
+            Time& _instance = Time::instance();
+
+            if (_instance.m_accumulator >= _instance.m_fixedStep)
+            {
+                if (_instance.m_steps < _instance.m_maxSteps)
+                {
+                    _instance.m_accumulator -= _instance.m_fixedStep;
+                    _instance.m_steps++;
+                    return true;
+                }
+
+                /*
+                * Catch-up cap reached. Drop the whole steps we could not run
+                * so a long stall does not snowball into every following frame.
+                */
+                _instance.m_accumulator %= _instance.m_fixedStep;
+            }
+
+            _instance.m_alpha = static_cast<float>(static_cast<double>(_instance.m_accumulator) / _instance.m_fixedStep);
+
+            return false;
+        }
+
+        float Time::FixedDeltaTime()
+        {
+            Time& _instance = Time::instance();
+
+            return static_cast<float>(TicksToSeconds(_instance.m_fixedStep));
+        }
+
+        float Time::InterpolationAlpha()
+        {
+            Time& _instance = Time::instance();
+
+            return _instance.m_alpha;
+        }
+
+        void Time::RecordPhase(FramePhase phase, uint64_t nanoseconds)
+        {
+            Time& _instance = Time::instance();
+
+            _instance.m_profiler.RecordPhase(phase, nanoseconds);
+        }
+
+        float Time::FrameTimePercentile(float percentile)
+        {
+            Time& _instance = Time::instance();
+
+            return static_cast<float>(_instance.m_profiler.FrameTimePercentile(percentile) / 1.0e6);
+        }
+
+        float Time::PhaseTimePercentile(FramePhase phase, float percentile)
+        {
+            Time& _instance = Time::instance();
+
+            return static_cast<float>(_instance.m_profiler.PhaseTimePercentile(phase, percentile) / 1.0e6);
+        }
+
+        float Time::MaxFrameTime()
+        {
+            Time& _instance = Time::instance();
+
+            return static_cast<float>(_instance.m_profiler.MaxFrameTime() / 1.0e6);
+        }
+
+        void Time::DumpFrameStats()
+        {
+            Time& _instance = Time::instance();
+
+            _instance.m_profiler.Dump();
+            _instance.m_pacer.Dump();
+        }
+
+        void Time::SetFramePacing(float targetFPS, uint32_t spinMicroseconds, PacingMode mode)
+        {
+            Time& _instance = Time::instance();
+
+            uint64_t period = (targetFPS > 0.0f) ? SecondsToTicks(1.0 / targetFPS) : 0;
+            _instance.m_pacer.Configure(period, static_cast<uint64_t>(spinMicroseconds) * 1000, mode);
+        }
+
+        void Time::WaitForNextFrame()
+        {
+            Time& _instance = Time::instance();
+
+            _instance.m_pacer.Wait();
+        }
+
+        void Time::RecordPresent()
+        {
+            Time& _instance = Time::instance();
+
+            _instance.m_pacer.RecordPresent(Ticks());
+        }
+
+        float Time::PresentInterval()
+        {
+            Time& _instance = Time::instance();
+
+            return static_cast<float>(_instance.m_pacer.PresentInterval() / 1.0e6);
+        }
+
+        uint64_t Time::PacingErrorCount(uint32_t bucket)
+        {
+            Time& _instance = Time::instance();
+
+            return _instance.m_pacer.HistogramCount(bucket);
+        }
+
+        float Time::PacingErrorBucketLimit(uint32_t bucket)
+        {
+            Time& _instance = Time::instance();
+
+            return static_cast<float>(_instance.m_pacer.HistogramUpperBound(bucket) / 1.0e3);
+        }
+
+        float Time::MaxPacingError()
         {
             Time& _instance = Time::instance();
 
-            return _instance.m_timer->TotalTime();
+            return static_cast<float>(_instance.m_pacer.MaxError() / 1.0e3);
         }
     }
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,587 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+
+#include <ht_transform_hierarchy.h>
+#include <ht_jobsystem.h>
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HT_TRANSFORM_SSE
+#include <xmmintrin.h>
+#endif
+#if defined(HT_TRANSFORM_SSE) && defined(__AVX__)
+#define HT_TRANSFORM_AVX
+#include <immintrin.h>
+#endif
+
+namespace Hatchit {
+
+    namespace Game {
+
+        const TransformId TransformHierarchy::ROOT;
+        const TransformId TransformHierarchy::INVALID;
+
+        static const uint32_t UNUSED = 0xFFFFFFFF;
+        static const uint32_t DEAD = 0xFFFFFFFE;
+
+        static const Matrix3x4 IDENTITY = { { 1.0f, 0.0f, 0.0f, 0.0f,
+                                              0.0f, 1.0f, 0.0f, 0.0f,
+                                              0.0f, 0.0f, 1.0f, 0.0f } };
+
+        /*
+        * Lane types for the batch kernel: WIDTH nodes per operation. Matrix
+        * loads and stores transpose between AoS world matrices and SoA lanes.
+        */
+        struct ScalarLanes
+        {
+            typedef float Vector;
+            static const uint32_t WIDTH = 1;
+
+            static Vector Load(const float* p) { return *p; }
+            static Vector Set1(float value) { return value; }
+            static Vector Add(Vector a, Vector b) { return a + b; }
+            static Vector Sub(Vector a, Vector b) { return a - b; }
+            static Vector Mul(Vector a, Vector b) { return a * b; }
+
+            static void LoadMatrices(const Matrix3x4* world, const uint32_t* parents, Vector out[12])
+            {
+                for (uint32_t i = 0; i < 12; i++)
+                    out[i] = world[parents[0]].m[i];
+            }
+
+            static void StoreMatrices(Matrix3x4* world, const Vector in[12])
+            {
+                for (uint32_t i = 0; i < 12; i++)
+                    world[0].m[i] = in[i];
+            }
+        };
+
+#ifdef HT_TRANSFORM_SSE
+        struct SSELanes
+        {
+            typedef __m128 Vector;
+            static const uint32_t WIDTH = 4;
+
+            static Vector Load(const float* p) { return _mm_loadu_ps(p); }
+            static Vector Set1(float value) { return _mm_set1_ps(value); }
+            static Vector Add(Vector a, Vector b) { return _mm_add_ps(a, b); }
+            static Vector Sub(Vector a, Vector b) { return _mm_sub_ps(a, b); }
+            static Vector Mul(Vector a, Vector b) { return _mm_mul_ps(a, b); }
+
+            static void LoadMatrices(const Matrix3x4* world, const uint32_t* parents, Vector out[12])
+            {
+                for (uint32_t row = 0; row < 3; row++)
+                {
+                    Vector a = _mm_loadu_ps(world[parents[0]].m + row * 4);
+                    Vector b = _mm_loadu_ps(world[parents[1]].m + row * 4);
+                    Vector c = _mm_loadu_ps(world[parents[2]].m + row * 4);
+                    Vector d = _mm_loadu_ps(world[parents[3]].m + row * 4);
+                    _MM_TRANSPOSE4_PS(a, b, c, d);
+                    out[row * 4 + 0] = a;
+                    out[row * 4 + 1] = b;
+                    out[row * 4 + 2] = c;
+                    out[row * 4 + 3] = d;
+                }
+            }
+
+            static void StoreMatrices(Matrix3x4* world, const Vector in[12])
+            {
+                for (uint32_t row = 0; row < 3; row++)
+                {
+                    Vector a = in[row * 4 + 0];
+                    Vector b = in[row * 4 + 1];
+                    Vector c = in[row * 4 + 2];
+                    Vector d = in[row * 4 + 3];
+                    _MM_TRANSPOSE4_PS(a, b, c, d);
+                    _mm_storeu_ps(world[0].m + row * 4, a);
+                    _mm_storeu_ps(world[1].m + row * 4, b);
+                    _mm_storeu_ps(world[2].m + row * 4, c);
+                    _mm_storeu_ps(world[3].m + row * 4, d);
+                }
+            }
+        };
+#endif
+
+#ifdef HT_TRANSFORM_AVX
+        struct AVXLanes
+        {
+            typedef __m256 Vector;
+            static const uint32_t WIDTH = 8;
+
+            static Vector Load(const float* p) { return _mm256_loadu_ps(p); }
+            static Vector Set1(float value) { return _mm256_set1_ps(value); }
+            static Vector Add(Vector a, Vector b) { return _mm256_add_ps(a, b); }
+            static Vector Sub(Vector a, Vector b) { return _mm256_sub_ps(a, b); }
+            static Vector Mul(Vector a, Vector b) { return _mm256_mul_ps(a, b); }
+
+            /*Two 4-wide transposes per row; the shuffles are not where the time goes*/
+            static void LoadMatrices(const Matrix3x4* world, const uint32_t* parents, Vector out[12])
+            {
+                __m128 low[12];
+                __m128 high[12];
+                SSELanes::LoadMatrices(world, parents, low);
+                SSELanes::LoadMatrices(world, parents + 4, high);
+                for (uint32_t i = 0; i < 12; i++)
+                    out[i] = _mm256_insertf128_ps(_mm256_castps128_ps256(low[i]), high[i], 1);
+            }
+
+            static void StoreMatrices(Matrix3x4* world, const Vector in[12])
+            {
+                __m128 low[12];
+                __m128 high[12];
+                for (uint32_t i = 0; i < 12; i++)
+                {
+                    low[i] = _mm256_castps256_ps128(in[i]);
+                    high[i] = _mm256_extractf128_ps(in[i], 1);
+                }
+                SSELanes::StoreMatrices(world, low);
+                SSELanes::StoreMatrices(world + 4, high);
+            }
+        };
+#endif
+
+        /*world = parent * (translation * rotation * scale) for L::WIDTH consecutive nodes*/
+        template <typename L>
+        static void ComputeBatch(const float* const* local, const uint32_t* parents, Matrix3x4* world, uint32_t first)
+        {
+            typedef typename L::Vector V;
+
+            V qx = L::Load(local[0] + first);
+            V qy = L::Load(local[1] + first);
+            V qz = L::Load(local[2] + first);
+            V qw = L::Load(local[3] + first);
+            V sx = L::Load(local[4] + first);
+            V sy = L::Load(local[5] + first);
+            V sz = L::Load(local[6] + first);
+
+            V one = L::Set1(1.0f);
+            V two = L::Set1(2.0f);
+            V xx = L::Mul(qx, qx);
+            V yy = L::Mul(qy, qy);
+            V zz = L::Mul(qz, qz);
+            V xy = L::Mul(qx, qy);
+            V xz = L::Mul(qx, qz);
+            V yz = L::Mul(qy, qz);
+            V wx = L::Mul(qw, qx);
+            V wy = L::Mul(qw, qy);
+            V wz = L::Mul(qw, qz);
+
+            V l[12];
+            l[0] = L::Mul(L::Sub(one, L::Mul(two, L::Add(yy, zz))), sx);
+            l[1] = L::Mul(L::Mul(two, L::Sub(xy, wz)), sy);
+            l[2] = L::Mul(L::Mul(two, L::Add(xz, wy)), sz);
+            l[3] = L::Load(local[7] + first);
+            l[4] = L::Mul(L::Mul(two, L::Add(xy, wz)), sx);
+            l[5] = L::Mul(L::Sub(one, L::Mul(two, L::Add(xx, zz))), sy);
+            l[6] = L::Mul(L::Mul(two, L::Sub(yz, wx)), sz);
+            l[7] = L::Load(local[8] + first);
+            l[8] = L::Mul(L::Mul(two, L::Sub(xz, wy)), sx);
+            l[9] = L::Mul(L::Mul(two, L::Add(yz, wx)), sy);
+            l[10] = L::Mul(L::Sub(one, L::Mul(two, L::Add(xx, yy))), sz);
+            l[11] = L::Load(local[9] + first);
+
+            V p[12];
+            L::LoadMatrices(world, parents + first, p);
+
+            V w[12];
+            for (uint32_t row = 0; row < 3; row++)
+            {
+                V p0 = p[row * 4 + 0];
+                V p1 = p[row * 4 + 1];
+                V p2 = p[row * 4 + 2];
+                for (uint32_t column = 0; column < 4; column++)
+                {
+                    V sum = L::Add(L::Add(L::Mul(p0, l[column]), L::Mul(p1, l[4 + column])), L::Mul(p2, l[8 + column]));
+                    w[row * 4 + column] = (column == 3) ? L::Add(sum, p[row * 4 + 3]) : sum;
+                }
+            }
+
+            L::StoreMatrices(world + first, w);
+        }
+
+        static bool AnyDirty(const uint8_t* dirty, uint32_t count)
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                if (dirty[i])
+                    return true;
+            }
+            return false;
+        }
+
+        TransformHierarchy::TransformHierarchy()
+        {
+            m_structureDirty = false;
+            m_anyDirty = false;
+            m_updated = 0;
+
+            /*Dense index 0 is the identity root; it is never computed*/
+            static const float rootLocal[CHANNEL_COUNT] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+            for (uint32_t c = 0; c < CHANNEL_COUNT; c++)
+                m_local[c].push_back(rootLocal[c]);
+            m_parent.push_back(0);
+            m_world.push_back(IDENTITY);
+            m_dirty.push_back(0);
+            m_destroyed.push_back(0);
+            m_ids.push_back(ROOT);
+            m_indexOf.push_back(0);
+            m_levels.push_back(0);
+            m_levels.push_back(1);
+        }
+
+        void TransformHierarchy::Reserve(uint32_t count)
+        {
+            count++;
+            for (uint32_t c = 0; c < CHANNEL_COUNT; c++)
+                m_local[c].reserve(count);
+            m_parent.reserve(count);
+            m_world.reserve(count);
+            m_dirty.reserve(count);
+            m_destroyed.reserve(count);
+            m_ids.reserve(count);
+            m_indexOf.reserve(count);
+        }
+
+        TransformId TransformHierarchy::Create(TransformId parent)
+        {
+            if (parent != ROOT && !Alive(parent))
+                return INVALID;
+
+            TransformId id;
+            if (!m_freeIds.empty())
+            {
+                id = m_freeIds.back();
+                m_freeIds.pop_back();
+            }
+            else
+            {
+                id = static_cast<TransformId>(m_indexOf.size());
+                m_indexOf.push_back(UNUSED);
+            }
+
+            static const float identityLocal[CHANNEL_COUNT] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+
+            uint32_t index = static_cast<uint32_t>(m_ids.size());
+            for (uint32_t c = 0; c < CHANNEL_COUNT; c++)
+                m_local[c].push_back(identityLocal[c]);
+            m_parent.push_back(m_indexOf[parent]);
+            m_world.push_back(IDENTITY);
+            m_dirty.push_back(1);
+            m_destroyed.push_back(0);
+            m_ids.push_back(id);
+            m_indexOf[id] = index;
+
+            m_structureDirty = true;
+            m_anyDirty = true;
+
+            return id;
+        }
+
+        void TransformHierarchy::Destroy(TransformId id)
+        {
+            if (id == ROOT || !Alive(id))
+                return;
+
+            m_destroyed[m_indexOf[id]] = 1;
+            m_structureDirty = true;
+        }
+
+        bool TransformHierarchy::SetParent(TransformId id, TransformId parent)
+        {
+            if (id == ROOT || !Alive(id) || (parent != ROOT && !Alive(parent)))
+                return false;
+
+            uint32_t index = m_indexOf[id];
+            for (uint32_t ancestor = m_indexOf[parent]; ancestor != 0; ancestor = m_parent[ancestor])
+            {
+                if (ancestor == index)
+                    return false;
+            }
+
+            m_parent[index] = m_indexOf[parent];
+            m_dirty[index] = 1;
+            m_structureDirty = true;
+            m_anyDirty = true;
+
+            return true;
+        }
+
+        TransformId TransformHierarchy::Parent(TransformId id) const
+        {
+            if (!Alive(id))
+                return INVALID;
+
+            return m_ids[m_parent[m_indexOf[id]]];
+        }
+
+        void TransformHierarchy::SetPosition(TransformId id, float x, float y, float z)
+        {
+            if (!Alive(id))
+                return;
+
+            uint32_t index = m_indexOf[id];
+            m_local[POSITION_X][index] = x;
+            m_local[POSITION_Y][index] = y;
+            m_local[POSITION_Z][index] = z;
+            m_dirty[index] = 1;
+            m_anyDirty = true;
+        }
+
+        void TransformHierarchy::SetRotation(TransformId id, float x, float y, float z, float w)
+        {
+            if (!Alive(id))
+                return;
+
+            uint32_t index = m_indexOf[id];
+            m_local[ROTATION_X][index] = x;
+            m_local[ROTATION_Y][index] = y;
+            m_local[ROTATION_Z][index] = z;
+            m_local[ROTATION_W][index] = w;
+            m_dirty[index] = 1;
+            m_anyDirty = true;
+        }
+
+        void TransformHierarchy::SetScale(TransformId id, float x, float y, float z)
+        {
+            if (!Alive(id))
+                return;
+
+            uint32_t index = m_indexOf[id];
+            m_local[SCALE_X][index] = x;
+            m_local[SCALE_Y][index] = y;
+            m_local[SCALE_Z][index] = z;
+            m_dirty[index] = 1;
+            m_anyDirty = true;
+        }
+
+        const Matrix3x4& TransformHierarchy::World(TransformId id) const
+        {
+            /*Dense index 0 is the identity root*/
+            return m_world[Alive(id) ? m_indexOf[id] : 0];
+        }
+
+        uint32_t TransformHierarchy::Count() const
+        {
+            return static_cast<uint32_t>(m_ids.size()) - 1;
+        }
+
+        uint32_t TransformHierarchy::UpdatedCount() const
+        {
+            return m_updated;
+        }
+
+        bool TransformHierarchy::Alive(TransformId id) const
+        {
+            return id < m_indexOf.size() && m_indexOf[id] != UNUSED && !m_destroyed[m_indexOf[id]];
+        }
+
+        void TransformHierarchy::Update()
+        {
+            if (m_structureDirty)
+                Rebuild();
+
+            m_updated = 0;
+            if (!m_anyDirty)
+                return;
+
+            for (size_t level = 1; level + 1 < m_levels.size(); level++)
+            {
+                uint32_t begin = m_levels[level];
+                uint32_t end = m_levels[level + 1];
+
+                /*Parents are final by now, so dirtiness flows down one level at a time*/
+                for (uint32_t i = begin; i < end; i++)
+                    m_dirty[i] |= m_dirty[m_parent[i]];
+
+                if (end - begin < PARALLEL_THRESHOLD)
+                {
+                    m_updated += UpdateRange(begin, end);
+                    continue;
+                }
+
+                LevelJob job;
+                job.hierarchy = this;
+                job.begin = begin;
+                job.end = end;
+                job.updated = 0;
+                JobSystem::ParallelFor((end - begin + PARALLEL_BATCH - 1) / PARALLEL_BATCH, 1, &TransformHierarchy::UpdateLevelBatch, &job);
+                m_updated += job.updated.load();
+            }
+
+            std::memset(m_dirty.data(), 0, m_dirty.size());
+            m_anyDirty = false;
+        }
+
+        void TransformHierarchy::UpdateLevelBatch(uint32_t begin, uint32_t end, void* data)
+        {
+            LevelJob* job = static_cast<LevelJob*>(data);
+
+            uint32_t first = job->begin + begin * PARALLEL_BATCH;
+            uint32_t last = std::min(job->end, job->begin + end * PARALLEL_BATCH);
+            job->updated += job->hierarchy->UpdateRange(first, last);
+        }
+
+        uint32_t TransformHierarchy::UpdateRange(uint32_t begin, uint32_t end)
+        {
+            const float* local[10];
+            local[0] = m_local[ROTATION_X].data();
+            local[1] = m_local[ROTATION_Y].data();
+            local[2] = m_local[ROTATION_Z].data();
+            local[3] = m_local[ROTATION_W].data();
+            local[4] = m_local[SCALE_X].data();
+            local[5] = m_local[SCALE_Y].data();
+            local[6] = m_local[SCALE_Z].data();
+            local[7] = m_local[POSITION_X].data();
+            local[8] = m_local[POSITION_Y].data();
+            local[9] = m_local[POSITION_Z].data();
+
+            const uint32_t* parents = m_parent.data();
+            const uint8_t* dirty = m_dirty.data();
+            Matrix3x4* world = m_world.data();
+
+            /*Whole batches are skipped when clean and computed when any lane is dirty*/
+            uint32_t updated = 0;
+            uint32_t i = begin;
+#ifdef HT_TRANSFORM_AVX
+            for (; i + AVXLanes::WIDTH <= end; i += AVXLanes::WIDTH)
+            {
+                if (AnyDirty(dirty + i, AVXLanes::WIDTH))
+                {
+                    ComputeBatch<AVXLanes>(local, parents, world, i);
+                    updated += AVXLanes::WIDTH;
+                }
+            }
+#endif
+#ifdef HT_TRANSFORM_SSE
+            for (; i + SSELanes::WIDTH <= end; i += SSELanes::WIDTH)
+            {
+                if (AnyDirty(dirty + i, SSELanes::WIDTH))
+                {
+                    ComputeBatch<SSELanes>(local, parents, world, i);
+                    updated += SSELanes::WIDTH;
+                }
+            }
+#endif
+            for (; i < end; i++)
+            {
+                if (dirty[i])
+                {
+                    ComputeBatch<ScalarLanes>(local, parents, world, i);
+                    updated++;
+                }
+            }
+
+            return updated;
+        }
+
+        void TransformHierarchy::Rebuild()
+        {
+            uint32_t count = static_cast<uint32_t>(m_ids.size());
+
+            /*Depth of every node, DEAD for destroyed nodes and their descendants*/
+            m_depth.assign(count, UNUSED);
+            m_depth[0] = 0;
+            uint32_t maxDepth = 0;
+            for (uint32_t i = 1; i < count; i++)
+            {
+                uint32_t node = i;
+                m_stack.clear();
+                while (m_depth[node] == UNUSED)
+                {
+                    m_stack.push_back(node);
+                    node = m_parent[node];
+                }
+
+                while (!m_stack.empty())
+                {
+                    uint32_t child = m_stack.back();
+                    m_stack.pop_back();
+
+                    uint32_t parentDepth = m_depth[m_parent[child]];
+                    m_depth[child] = (m_destroyed[child] || parentDepth == DEAD) ? DEAD : parentDepth + 1;
+                    if (m_depth[child] != DEAD)
+                        maxDepth = std::max(maxDepth, m_depth[child]);
+                }
+            }
+
+            /*Counting sort by depth; stable, so siblings keep their relative order*/
+            m_levels.assign(maxDepth + 2, 0);
+            for (uint32_t i = 0; i < count; i++)
+            {
+                if (m_depth[i] != DEAD)
+                    m_levels[m_depth[i] + 1]++;
+            }
+            for (uint32_t level = 1; level < m_levels.size(); level++)
+                m_levels[level] += m_levels[level - 1];
+
+            uint32_t alive = m_levels.back();
+            m_order.resize(alive);
+            m_scratchIndices.assign(count, UNUSED);
+            m_stack.assign(m_levels.begin(), m_levels.end());
+            for (uint32_t i = 0; i < count; i++)
+            {
+                if (m_depth[i] == DEAD)
+                {
+                    m_indexOf[m_ids[i]] = UNUSED;
+                    m_freeIds.push_back(m_ids[i]);
+                    continue;
+                }
+
+                uint32_t target = m_stack[m_depth[i]]++;
+                m_order[target] = i;
+                m_scratchIndices[i] = target;
+            }
+
+            /*Apply the permutation to every array*/
+            for (uint32_t c = 0; c < CHANNEL_COUNT; c++)
+            {
+                m_scratchFloats.resize(alive);
+                for (uint32_t k = 0; k < alive; k++)
+                    m_scratchFloats[k] = m_local[c][m_order[k]];
+                m_local[c].swap(m_scratchFloats);
+            }
+
+            m_stack.resize(alive);
+            for (uint32_t k = 0; k < alive; k++)
+                m_stack[k] = m_scratchIndices[m_parent[m_order[k]]];
+            m_parent.swap(m_stack);
+
+            m_scratchWorld.resize(alive);
+            for (uint32_t k = 0; k < alive; k++)
+                m_scratchWorld[k] = m_world[m_order[k]];
+            m_world.swap(m_scratchWorld);
+
+            m_scratchBytes.resize(alive);
+            for (uint32_t k = 0; k < alive; k++)
+                m_scratchBytes[k] = m_dirty[m_order[k]];
+            m_dirty.swap(m_scratchBytes);
+
+            m_destroyed.assign(alive, 0);
+
+            m_stack.resize(alive);
+            for (uint32_t k = 0; k < alive; k++)
+                m_stack[k] = m_ids[m_order[k]];
+            m_ids.swap(m_stack);
+            for (uint32_t k = 0; k < alive; k++)
+                m_indexOf[m_ids[k]] = k;
+
+            m_structureDirty = false;
+        }
+
+    }
+
+}
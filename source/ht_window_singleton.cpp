@@ -15,6 +15,8 @@
 #include <ht_window_singleton.h>
 #include <ht_debug.h>
 #include <ht_sdlwindow.h>
+#include <ht_nullwindow.h>
+#include <ht_static_backend.h>
 
 namespace Hatchit {
 
@@ -24,7 +26,16 @@ namespace Hatchit {
         {
             Window& _instance = Window::instance();
 
-            _instance.m_window = new SDLWindow(params);
+#ifdef HT_STATIC_BACKEND
+            StaticWindowType* window = new StaticWindowType(params);
+            FrameBackend::BindWindow(window);
+            _instance.m_window = window;
+#else
+            if (params.backend == WindowBackend::HEADLESS)
+                _instance.m_window = new NullWindow(params);
+            else
+                _instance.m_window = new SDLWindow(params);
+#endif
             if (!_instance.m_window->VInitialize())
             {
 #ifdef _DEBUG
@@ -33,6 +44,9 @@ namespace Hatchit {
                 return false;
             }
 
+            /*Event-driven loops still need to draw the first frame*/
+            _instance.m_redrawRequested = true;
+
             return true;
         }
 
@@ -41,6 +55,10 @@ namespace Hatchit {
             Window& _instance = Window::instance();
 
             delete _instance.m_window;
+            _instance.m_window = nullptr;
+#ifdef HT_STATIC_BACKEND
+            FrameBackend::BindWindow(nullptr);
+#endif
         }
 
         void Window::PollEvents()
@@ -50,6 +68,29 @@ namespace Hatchit {
             _instance.m_window->VPollEvents();
         }
 
+        bool Window::WaitEvents(uint32_t timeoutMs)
+        {
+            Window& _instance = Window::instance();
+
+            return _instance.m_window->VWaitEvents(timeoutMs);
+        }
+
+        void Window::RequestRedraw()
+        {
+            Window& _instance = Window::instance();
+
+            /*Callable from any thread; wakes a loop blocked in WaitEvents*/
+            if (!_instance.m_redrawRequested.exchange(true) && _instance.m_window)
+                _instance.m_window->VWake();
+        }
+
+        bool Window::ConsumeRedraw()
+        {
+            Window& _instance = Window::instance();
+
+            return _instance.m_redrawRequested.exchange(false);
+        }
+
         void Window::Close()
         {
             Window& _instance = Window::instance();
@@ -71,6 +112,34 @@ namespace Hatchit {
             _instance.m_window->VSwapBuffers();
         }
 
+        void Window::MakeContextCurrent(bool current)
+        {
+            Window& _instance = Window::instance();
+
+            _instance.m_window->VMakeContextCurrent(current);
+        }
+
+        bool Window::IsVisible()
+        {
+            Window& _instance = Window::instance();
+
+            return _instance.m_window->VIsVisible();
+        }
+
+        bool Window::HasFocus()
+        {
+            Window& _instance = Window::instance();
+
+            return _instance.m_window->VHasFocus();
+        }
+
+        void Window::SetDisplayFPS(bool display)
+        {
+            Window& _instance = Window::instance();
+
+            _instance.m_window->VSetDisplayFPS(display);
+        }
+
         void* Window::NativeHandle()
         {
             Window& _instance = Window::instance();
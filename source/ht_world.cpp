@@ -0,0 +1,303 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+
+#include <ht_world.h>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        World::World()
+        {
+            m_emptyArchetype = nullptr;
+            m_entityCount = 0;
+        }
+
+        World::~World()
+        {
+            DeInitialize();
+        }
+
+        bool World::Initialize(uint32_t threadCount)
+        {
+            DeInitialize();
+
+            m_emptyArchetype = FindArchetype(0);
+            SetThreadCount(threadCount);
+
+            return true;
+        }
+
+        void World::DeInitialize()
+        {
+            for (size_t i = 0; i < m_archetypes.size(); i++)
+                delete m_archetypes[i];
+            m_archetypes.clear();
+            m_archetypeLookup.clear();
+            m_emptyArchetype = nullptr;
+
+            m_records.clear();
+            m_freeIndices.clear();
+            m_commands.clear();
+            m_entityCount = 0;
+        }
+
+        void World::SetThreadCount(uint32_t threadCount)
+        {
+            /*Only grows, so buffers recorded before a job system restart survive*/
+            if (threadCount > m_commands.size())
+                m_commands.resize(threadCount);
+        }
+
+        Entity World::Create()
+        {
+            return Place(m_emptyArchetype);
+        }
+
+        void World::Destroy(Entity entity)
+        {
+            if (!IsAlive(entity))
+                return;
+
+            EntityRecord& record = m_records[entity.index];
+            Detach(record);
+            record.archetype = nullptr;
+            record.generation++;
+            m_freeIndices.push_back(entity.index);
+            m_entityCount--;
+        }
+
+        bool World::IsAlive(Entity entity) const
+        {
+            return entity.index < m_records.size() &&
+                m_records[entity.index].generation == entity.generation &&
+                m_records[entity.index].archetype != nullptr;
+        }
+
+        uint32_t World::EntityCount() const
+        {
+            return m_entityCount;
+        }
+
+        uint32_t World::ArchetypeCount() const
+        {
+            return static_cast<uint32_t>(m_archetypes.size());
+        }
+
+        void World::AddRaw(Entity entity, ComponentId id, const void* data)
+        {
+            if (!IsAlive(entity))
+                return;
+
+            /*Adding a component the entity already has just overwrites it*/
+            EntityRecord& record = m_records[entity.index];
+            if (!record.archetype->Has(id))
+                Move(entity, AddTransition(record.archetype, id));
+
+            std::memcpy(record.archetype->Component(record.chunk, record.row, id), data, ComponentRegistry::Info(id).size);
+        }
+
+        void World::RemoveRaw(Entity entity, ComponentId id)
+        {
+            if (!IsAlive(entity))
+                return;
+
+            EntityRecord& record = m_records[entity.index];
+            if (record.archetype->Has(id))
+                Move(entity, RemoveTransition(record.archetype, id));
+        }
+
+        EntityCommandBuffer& World::Commands()
+        {
+            return m_commands[JobSystem::ThreadIndex()];
+        }
+
+        void World::FlushCommands()
+        {
+            /*Thread order, then recording order, so playback is deterministic per thread*/
+            for (size_t i = 0; i < m_commands.size(); i++)
+            {
+                if (m_commands[i].Count() > 0)
+                    Playback(m_commands[i]);
+            }
+        }
+
+        void World::Playback(EntityCommandBuffer& buffer)
+        {
+            typedef EntityCommandBuffer::CommandHeader CommandHeader;
+            typedef EntityCommandBuffer::CommandType CommandType;
+
+            m_placeholders.resize(buffer.m_created);
+
+            size_t offset = 0;
+            while (offset < buffer.m_data.size())
+            {
+                CommandHeader header;
+                std::memcpy(&header, &buffer.m_data[offset], sizeof(header));
+                const uint8_t* payload = &buffer.m_data[offset + sizeof(header)];
+                offset += header.stride;
+
+                Entity entity = header.entity;
+                if (entity.index & EntityCommandBuffer::PLACEHOLDER_BIT)
+                {
+                    if (header.type == CommandType::CREATE)
+                    {
+                        m_placeholders[entity.index & ~EntityCommandBuffer::PLACEHOLDER_BIT] = Create();
+                        continue;
+                    }
+                    entity = m_placeholders[entity.index & ~EntityCommandBuffer::PLACEHOLDER_BIT];
+                }
+
+                /*Entities destroyed earlier (e.g. by another thread's buffer) are skipped*/
+                switch (header.type)
+                {
+                case CommandType::DESTROY:
+                    Destroy(entity);
+                    break;
+
+                case CommandType::ADD:
+                    AddRaw(entity, header.component, payload);
+                    break;
+
+                case CommandType::REMOVE:
+                    RemoveRaw(entity, header.component);
+                    break;
+
+                default:
+                    break;
+                }
+            }
+
+            buffer.Reset();
+        }
+
+        Archetype* World::FindArchetype(ComponentMask mask)
+        {
+            std::unordered_map<ComponentMask, Archetype*>::iterator found = m_archetypeLookup.find(mask);
+            if (found != m_archetypeLookup.end())
+                return found->second;
+
+            Archetype* archetype = new Archetype(mask);
+            m_archetypes.push_back(archetype);
+            m_archetypeLookup[mask] = archetype;
+
+            return archetype;
+        }
+
+        Archetype* World::AddTransition(Archetype* archetype, ComponentId id)
+        {
+            if (!archetype->m_addEdges[id])
+            {
+                Archetype* target = FindArchetype(archetype->Mask() | (ComponentMask(1) << id));
+                archetype->m_addEdges[id] = target;
+                target->m_removeEdges[id] = archetype;
+            }
+
+            return archetype->m_addEdges[id];
+        }
+
+        Archetype* World::RemoveTransition(Archetype* archetype, ComponentId id)
+        {
+            if (!archetype->m_removeEdges[id])
+            {
+                Archetype* target = FindArchetype(archetype->Mask() & ~(ComponentMask(1) << id));
+                archetype->m_removeEdges[id] = target;
+                target->m_addEdges[id] = archetype;
+            }
+
+            return archetype->m_removeEdges[id];
+        }
+
+        Entity World::Place(Archetype* archetype)
+        {
+            Entity entity;
+            if (!m_freeIndices.empty())
+            {
+                entity.index = m_freeIndices.back();
+                m_freeIndices.pop_back();
+            }
+            else
+            {
+                entity.index = static_cast<uint32_t>(m_records.size());
+                EntityRecord created;
+                created.archetype = nullptr;
+                created.generation = 0;
+                m_records.push_back(created);
+            }
+
+            EntityRecord& record = m_records[entity.index];
+            entity.generation = record.generation;
+            record.archetype = archetype;
+            archetype->Append(entity, record.chunk, record.row);
+            m_entityCount++;
+
+            return entity;
+        }
+
+        void World::Move(Entity entity, Archetype* target)
+        {
+            EntityRecord& record = m_records[entity.index];
+            Archetype* source = record.archetype;
+
+            uint32_t chunk;
+            uint32_t row;
+            target->Append(entity, chunk, row);
+
+            /*Carry over every component both archetypes share*/
+            ComponentMask shared = source->Mask() & target->Mask();
+            for (ComponentId id = 0; shared != 0; id++, shared >>= 1)
+            {
+                if (shared & 1)
+                    std::memcpy(target->Component(chunk, row, id), source->Component(record.chunk, record.row, id), ComponentRegistry::Info(id).size);
+            }
+
+            Detach(record);
+            record.archetype = target;
+            record.chunk = chunk;
+            record.row = row;
+        }
+
+        void World::Detach(EntityRecord& record)
+        {
+            Entity moved = record.archetype->RemoveSwap(record.chunk, record.row);
+            if (moved != NULL_ENTITY)
+            {
+                m_records[moved.index].chunk = record.chunk;
+                m_records[moved.index].row = record.row;
+            }
+        }
+
+        void World::GatherChunks(ComponentMask mask)
+        {
+            m_chunkRefs.clear();
+            for (size_t a = 0; a < m_archetypes.size(); a++)
+            {
+                Archetype* archetype = m_archetypes[a];
+                if ((archetype->Mask() & mask) != mask)
+                    continue;
+
+                for (uint32_t c = 0; c < archetype->ChunkCount(); c++)
+                {
+                    ChunkRef ref;
+                    ref.archetype = archetype;
+                    ref.chunk = c;
+                    m_chunkRefs.push_back(ref);
+                }
+            }
+        }
+
+    }
+
+}
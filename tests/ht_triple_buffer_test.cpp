@@ -0,0 +1,134 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_triple_buffer.h>
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+
+using namespace Hatchit::Game;
+
+namespace
+{
+    static const uint32_t WORDS = 61;
+    static const uint64_t PUBLISHES = 2000000;
+
+    /*Every word is derived from the sequence, so a torn read shows up as a mismatch*/
+    struct Payload
+    {
+        uint64_t sequence;
+        uint64_t words[WORDS];
+        uint64_t checksum;
+    };
+
+    uint64_t Word(uint64_t sequence, uint32_t i)
+    {
+        return sequence * 0x9E3779B97F4A7C15ull + i;
+    }
+
+    void Fill(Payload& payload, uint64_t sequence)
+    {
+        payload.sequence = sequence;
+        uint64_t checksum = 0;
+        for (uint32_t i = 0; i < WORDS; i++)
+        {
+            payload.words[i] = Word(sequence, i);
+            checksum ^= payload.words[i];
+        }
+        payload.checksum = checksum;
+    }
+
+    bool Valid(const Payload& payload)
+    {
+        uint64_t checksum = 0;
+        for (uint32_t i = 0; i < WORDS; i++)
+        {
+            if (payload.words[i] != Word(payload.sequence, i))
+                return false;
+            checksum ^= payload.words[i];
+        }
+        return checksum == payload.checksum;
+    }
+}
+
+/*
+* Races one writer against one reader. The reader must only ever see
+* complete payloads, in strictly increasing order, and must end on the
+* last one published. Returns nonzero on the first violation.
+*/
+int main()
+{
+    TripleBuffer<Payload> buffer;
+    Fill(buffer.WriteBuffer(), 0);
+
+    std::atomic<bool> done(false);
+    std::atomic<uint64_t> failures(0);
+    uint64_t acquired = 0;
+
+    std::thread reader([&]()
+    {
+        uint64_t last = 0;
+        for (;;)
+        {
+            /*Read done before Acquire so the final publish is always seen*/
+            bool finished = done.load(std::memory_order_acquire);
+            if (buffer.Acquire())
+            {
+                const Payload& payload = buffer.ReadBuffer();
+                if (!Valid(payload))
+                {
+                    std::printf("FAIL: torn payload at sequence %llu\n", (unsigned long long)payload.sequence);
+                    failures++;
+                    return;
+                }
+                if (payload.sequence <= last)
+                {
+                    std::printf("FAIL: sequence went from %llu to %llu\n",
+                        (unsigned long long)last, (unsigned long long)payload.sequence);
+                    failures++;
+                    return;
+                }
+                last = payload.sequence;
+                acquired++;
+            }
+            else if (finished)
+            {
+                break;
+            }
+        }
+
+        if (last != PUBLISHES)
+        {
+            std::printf("FAIL: reader ended on %llu, expected %llu\n",
+                (unsigned long long)last, (unsigned long long)PUBLISHES);
+            failures++;
+        }
+    });
+
+    for (uint64_t sequence = 1; sequence <= PUBLISHES; sequence++)
+    {
+        Fill(buffer.WriteBuffer(), sequence);
+        buffer.Publish();
+    }
+    done.store(true, std::memory_order_release);
+
+    reader.join();
+
+    if (failures.load() != 0)
+        return 1;
+
+    std::printf("OK: %llu published, %llu acquired\n", (unsigned long long)PUBLISHES, (unsigned long long)acquired);
+    return 0;
+}